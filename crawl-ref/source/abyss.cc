@@ -62,6 +62,7 @@ const coord_def ABYSS_CENTRE(GXM / 2, GYM / 2);
 abyss_state abyssal_state;
 
 static ProceduralLayout *abyssLayout = nullptr, *levelLayout = nullptr;
+static CachedLayout *abyssSamples = nullptr;
 
 typedef priority_queue<ProceduralSample, vector<ProceduralSample>, ProceduralSamplePQCompare> sample_queue;
 
@@ -869,6 +870,19 @@ const static RiverLayout rivers(1800, baseLayout);
 // This one is not fixed: [0] is a level pulled from the current game
 static vector<const ProceduralLayout*> complex_vec(2);
 
+static void _abyss_init_layout()
+{
+    if (abyssLayout == nullptr)
+    {
+        const level_id lid = _get_random_level();
+        levelLayout = new LevelLayout(lid, 5, rivers);
+        complex_vec[0] = levelLayout;
+        complex_vec[1] = &rivers; // const
+        abyssLayout = new WorleyLayout(23571113, complex_vec, 6.1);
+        abyssSamples = new CachedLayout(*abyssLayout);
+    }
+}
+
 static ProceduralSample _abyss_grid(const coord_def &p)
 {
     const coord_def pt = p + abyssal_state.major_coord;
@@ -880,16 +894,9 @@ static ProceduralSample _abyss_grid(const coord_def &p)
         return sample;
     }
 
-    if (abyssLayout == nullptr)
-    {
-        const level_id lid = _get_random_level();
-        levelLayout = new LevelLayout(lid, 5, rivers);
-        complex_vec[0] = levelLayout;
-        complex_vec[1] = &rivers; // const
-        abyssLayout = new WorleyLayout(23571113, complex_vec, 6.1);
-    }
+    _abyss_init_layout();
 
-    const ProceduralSample sample = (*abyssLayout)(pt, abyssal_state.depth);
+    const ProceduralSample sample = (*abyssSamples)(pt, abyssal_state.depth);
     ASSERT(sample.feat() > DNGN_UNSEEN);
 
     abyss_sample_queue.push(sample);
@@ -941,38 +948,48 @@ static dungeon_feature_type _veto_dangerous_terrain(dungeon_feature_type feat)
     return feat;
 }
 
-static void _update_abyss_terrain(const coord_def &p,
-    const map_bitmask &abyss_genlevel_mask, bool morph)
+// Would _update_abyss_terrain look at the layout for this square?
+static bool _abyss_needs_sample(const coord_def &rp,
+                                const map_bitmask &abyss_genlevel_mask,
+                                bool morph)
 {
-    const coord_def rp = p - abyssal_state.major_coord;
     // ignore dead coordinates
     if (!in_bounds(rp))
-        return;
+        return false;
 
     const dungeon_feature_type currfeat = grd(rp);
 
     // Don't decay vaults.
     if (map_masked(rp, MMT_VAULT))
-        return;
+        return false;
 
     switch (currfeat)
     {
         case DNGN_EXIT_ABYSS:
         case DNGN_ABYSSAL_STAIR:
-            return;
+            return false;
         default:
             break;
     }
 
     if (feat_is_altar(currfeat))
-        return;
+        return false;
 
     if (!abyss_genlevel_mask(rp))
-        return;
+        return false;
 
-    if (currfeat != DNGN_UNSEEN && !morph)
+    return currfeat == DNGN_UNSEEN || morph;
+}
+
+static void _update_abyss_terrain(const coord_def &p,
+    const map_bitmask &abyss_genlevel_mask, bool morph)
+{
+    const coord_def rp = p - abyssal_state.major_coord;
+    if (!_abyss_needs_sample(rp, abyss_genlevel_mask, morph))
         return;
 
+    const dungeon_feature_type currfeat = grd(rp);
+
     // What should have been there previously?  It might not be because
     // of external changes such as digging.
     const ProceduralSample sample = _abyss_grid(rp);
@@ -1039,6 +1056,37 @@ static void _ensure_player_habitable(bool dig_instead)
     }
 }
 
+// Evaluate the layout a row at a time for all the squares that the main
+// loop of _abyss_apply_terrain is going to resample, so that it only has to
+// read them back from the cache.
+static void _abyss_prefetch_terrain(const map_bitmask &abyss_genlevel_mask,
+                                    bool morph, bool now)
+{
+    _abyss_init_layout();
+
+    for (int y = MAPGEN_BORDER; y < GYM - MAPGEN_BORDER; ++y)
+    {
+        int run_start = -1;
+        for (int x = MAPGEN_BORDER; x <= GXM - MAPGEN_BORDER; ++x)
+        {
+            const coord_def p(x, y);
+            const bool wanted = x < GXM - MAPGEN_BORDER
+                && (now || !map_masked(p, MMT_TURNED_TO_FLOOR))
+                && !_in_wastes(p + abyssal_state.major_coord)
+                && _abyss_needs_sample(p, abyss_genlevel_mask, morph);
+            if (wanted && run_start < 0)
+                run_start = x;
+            else if (!wanted && run_start >= 0)
+            {
+                abyssSamples->prefetch(
+                    coord_def(run_start, y) + abyssal_state.major_coord,
+                    x - run_start, abyssal_state.depth);
+                run_start = -1;
+            }
+        }
+    }
+}
+
 static void _abyss_apply_terrain(const map_bitmask &abyss_genlevel_mask,
                                  bool morph = false, bool now = false)
 {
@@ -1067,6 +1115,9 @@ static void _abyss_apply_terrain(const map_bitmask &abyss_genlevel_mask,
 */
     }
 
+    if (!used_queue)
+        _abyss_prefetch_terrain(abyss_genlevel_mask, morph, now);
+
     int ii = 0;
     int delta = you.time_taken * (you.abyss_speed + 40) / 200;
     for (rectangle_iterator ri(MAPGEN_BORDER); ri; ++ri)
@@ -1244,6 +1295,8 @@ void destroy_abyss()
 {
     if (abyssLayout)
     {
+        delete abyssSamples;
+        abyssSamples = nullptr;
         delete abyssLayout;
         abyssLayout = nullptr;
         delete levelLayout;
@@ -53,6 +53,7 @@ LOCAL_SRC_FILES := $(SDL_PATH)/src/main/android/SDL_android_main.c \
     $(CRAWL_PATH)/dbg-asrt.cc \
     $(CRAWL_PATH)/dbg-maps.cc \
     $(CRAWL_PATH)/dbg-objstat.cc \
+    $(CRAWL_PATH)/dbg-prof.cc \
     $(CRAWL_PATH)/dbg-scan.cc \
     $(CRAWL_PATH)/dbg-util.cc \
     $(CRAWL_PATH)/decks.cc \
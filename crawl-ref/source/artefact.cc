@@ -1039,18 +1039,49 @@ void artefact_properties(const item_def &item,
     artefact_properties(item, proprt, known);
 }
 
+/**
+ * One entry of what artefact_properties() would fill in, read straight out
+ * of the item's props rather than copying out every property to get it.
+ *
+ * @param item    The artefact.
+ * @param prop    The property to look up.
+ * @param[out] known Whether the player knows the property.
+ * @return the property's value.
+ */
 int artefact_property(const item_def &item, artefact_prop_type prop,
-                      bool &_known)
+                      bool &known)
 {
-    artefact_properties_t  proprt;
-    artefact_known_props_t known;
-    proprt.init(0);
-    known.init(0);
+    ASSERT(is_artefact(item));
+    known = false;
+    if (!item.props.exists(KNOWN_PROPS_KEY))
+        return 0;
 
-    artefact_properties(item, proprt, known);
+    const CrawlStoreValue &_val = item.props[KNOWN_PROPS_KEY];
+    ASSERT(_val.get_type() == SV_VEC);
+    const CrawlVector &known_vec = _val.get_vector();
+    ASSERT(known_vec.get_type()     == SV_BOOL);
+    ASSERT(known_vec.size()         == ART_PROPERTIES);
+    ASSERT(known_vec.get_max_size() == ART_PROPERTIES);
 
-    _known = known[prop];
+    known = item_ident(item, ISFLAG_KNOW_PROPERTIES)
+            || known_vec[prop].get_bool();
 
+    if (item.props.exists(ARTEFACT_PROPS_KEY))
+    {
+        const CrawlVector &rap_vec =
+            item.props[ARTEFACT_PROPS_KEY].get_vector();
+        ASSERT(rap_vec.get_type()     == SV_SHORT);
+        ASSERT(rap_vec.size()         == ART_PROPERTIES);
+        ASSERT(rap_vec.get_max_size() == ART_PROPERTIES);
+
+        return rap_vec[prop].get_short();
+    }
+    else if (is_unrandom_artefact(item))
+        return static_cast<short>(_seekunrandart(item)->prpty[prop]);
+
+    artefact_properties_t proprt;
+    proprt.init(0);
+    _get_randart_properties(item, proprt);
     return proprt[prop];
 }
 
@@ -1063,17 +1094,10 @@ int artefact_property(const item_def &item, artefact_prop_type prop)
 
 int artefact_known_property(const item_def &item, artefact_prop_type prop)
 {
-    artefact_properties_t  proprt;
-    artefact_known_props_t known;
-    proprt.init(0);
-    known.init(0);
-
-    artefact_properties(item, proprt, known);
+    bool known;
+    const int value = artefact_property(item, prop, known);
 
-    if (known[prop])
-        return proprt[prop];
-    else
-        return 0;
+    return known ? value : 0;
 }
 
 static int _artefact_num_props(const artefact_properties_t &proprt)
@@ -1103,6 +1127,7 @@ void artefact_learn_prop(item_def &item, artefact_prop_type prop)
         return;
 
     known_vec[prop] = static_cast<bool>(true);
+    invalidate_item_names();
 }
 
 static string _get_artefact_type(const item_def &item, bool appear = false)
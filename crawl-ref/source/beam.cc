@@ -15,6 +15,7 @@
 #include <cstring>
 #include <iostream>
 #include <set>
+#include <sstream>
 
 #include "act-iter.h"
 #include "areas.h"
@@ -2213,6 +2214,54 @@ int silver_damages_victim(actor* victim, int damage, string &dmg_msg)
 //
 //  Note that beam properties must be set, as the tracer will take them
 //  into account, as well as the monster's intelligence.
+static map<string, bolt> *_tracer_cache = nullptr;
+
+tracer_cache_scope::tracer_cache_scope() : prev(_tracer_cache)
+{
+    _tracer_cache = &results;
+}
+
+tracer_cache_scope::~tracer_cache_scope()
+{
+    _tracer_cache = prev;
+}
+
+// Everything a monster's tracer depends on besides the state of the level,
+// or "" if its result can't be reused: random flavours pick a new flavour
+// each time, and a beam that has already been fired carries state from it.
+static string _tracer_key(const monster &mons, const bolt &b,
+                          bool explode_only, bool explosion_hole)
+{
+    if (b.real_flavour == BEAM_RANDOM || b.real_flavour == BEAM_CHAOS
+        || b.real_flavour == BEAM_CRYSTAL || b.special_explosion
+        || b.chose_ray || !b.path_taken.empty() || !b.hit_count.empty())
+    {
+        return "";
+    }
+
+    ostringstream key;
+    key << mons.mid << ' ' << explode_only << explosion_hole << ' '
+        << b.origin_spell << ' ' << b.range << ' ' << (int)b.glyph << ' '
+        << (int)b.colour << ' ' << b.flavour << ' ' << b.real_flavour << ' '
+        << b.drop_item << ' ' << (const void *)b.item << ' '
+        << b.source.x << ',' << b.source.y << ' '
+        << b.target.x << ',' << b.target.y << ' '
+        << b.damage.num << 'd' << b.damage.size << ' ' << b.ench_power << ' '
+        << b.hit << ' ' << b.thrower << ' ' << b.ex_size << ' '
+        << b.source_id << ' ' << b.loudness << ' ' << b.pierce
+        << b.is_explosion << b.aimed_at_spot << b.affects_nothing
+        << b.effect_known << b.effect_wanton << b.was_missile << b.evoked
+        << b.is_targeting << b.aimed_at_feet << b.passed_target
+        << b.use_target_as_pos << b.auto_hit << b.dont_stop_player
+        << b.dont_stop_trees << ' ' << b.ac_rule << ' ' << b.attitude << ' '
+        << b.foe_ratio << ' ' << b.extra_range_used << ' '
+        << b.reflector << ' ' << b.bounce_pos.x << ',' << b.bounce_pos.y
+        << '\n' << b.source_name << '\n' << b.name << '\n' << b.short_name
+        << '\n' << b.hit_verb << '\n' << b.aux_source << '\n'
+        << b.hit_noise_msg << '\n' << b.explode_noise_msg;
+    return key.str();
+}
+
 void fire_tracer(const monster* mons, bolt &pbolt, bool explode_only,
                  bool explosion_hole)
 {
@@ -2249,6 +2298,20 @@ void fire_tracer(const monster* mons, bolt &pbolt, bool explode_only,
 
     pbolt.in_explosion_phase = false;
 
+    const string key = _tracer_cache
+                       ? _tracer_key(*mons, pbolt, explode_only,
+                                     explosion_hole)
+                       : "";
+    if (!key.empty())
+    {
+        auto cached = _tracer_cache->find(key);
+        if (cached != _tracer_cache->end())
+        {
+            pbolt = cached->second;
+            return;
+        }
+    }
+
     // Fire!
     if (explode_only)
         pbolt.explode(false, explosion_hole);
@@ -2257,6 +2320,9 @@ void fire_tracer(const monster* mons, bolt &pbolt, bool explode_only,
 
     // Unset tracer flag (convenience).
     pbolt.is_tracer = false;
+
+    if (!key.empty())
+        (*_tracer_cache)[key] = pbolt;
 }
 
 static coord_def _random_point_hittable_from(const coord_def &c,
@@ -321,6 +321,22 @@ bool curare_actor(actor* source, actor* target, int levels, string name,
 int silver_damages_victim(actor* victim, int damage, string &dmg_msg);
 void fire_tracer(const monster* mons, bolt &pbolt,
                   bool explode_only = false, bool explosion_hole = false);
+
+// While one of these exists, fire_tracer() remembers what its tracers did,
+// and a tracer fired again by the same monster with exactly the same beam
+// reuses the result instead of walking the ray again. Only for use while
+// nothing can change the map or the actors on it, such as while a monster
+// weighs up its spells.
+class tracer_cache_scope
+{
+public:
+    tracer_cache_scope();
+    ~tracer_cache_scope();
+
+private:
+    map<string, bolt> results;
+    map<string, bolt> *prev;
+};
 bool imb_can_splash(coord_def origin, coord_def center,
                     vector<coord_def> path_taken, coord_def target);
 spret_type zapping(zap_type ztype, int power, bolt &pbolt,
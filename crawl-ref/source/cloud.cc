@@ -15,6 +15,7 @@
 #include "art-enum.h"
 #include "colour.h"
 #include "coordit.h"
+#include "dbg-prof.h"
 #include "dungeon.h"
 #include "english.h"
 #include "godconduct.h"
@@ -625,6 +626,7 @@ static void _handle_spectral_cloud(const cloud_struct& cloud)
 
 void manage_clouds()
 {
+    PROF_SCOPE("manage_clouds");
     // We can't iterate over env.cloud directly because _dissipate_cloud
     // will remove this cloud and invalidate our iterator.
     vector<cloud_struct *> cloud_ptrs;
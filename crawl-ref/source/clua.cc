@@ -55,8 +55,8 @@ CLua::CLua(bool managed)
       throttle_sleep_ms(0), throttle_sleep_start(2),
       throttle_sleep_end(800), n_throttle_sleeps(0), mixed_call_depth(0),
       lua_call_depth(0), max_mixed_call_depth(8),
-      max_lua_call_depth(100), memory_used(0),
-      _state(nullptr), sourced_files(), uniqindex(0)
+      max_lua_call_depth(100), memory_used(0), profile_calls(false),
+      call_profiles(), _state(nullptr), sourced_files(), uniqindex(0)
 {
 }
 
@@ -344,9 +344,63 @@ int CLua::execfile(const char *filename, bool trusted, bool die_on_fail,
     return err;
 }
 
+// Adds the time until it goes out of scope to the profile of the named
+// function, if the VM is profiling calls.
+class lua_call_timer
+{
+public:
+    lua_call_timer(CLua &_vm, const char *_name)
+        : vm(_vm), name(_vm.profile_calls ? _name : nullptr),
+          start(name ? chrono::steady_clock::now()
+                     : chrono::steady_clock::time_point())
+    {
+    }
+
+    ~lua_call_timer()
+    {
+        if (!name)
+            return;
+
+        const double ms = chrono::duration<double, milli>(
+                              chrono::steady_clock::now() - start).count();
+        CLua::call_profile &prof = vm.call_profiles[name];
+        ++prof.calls;
+        prof.total_ms += ms;
+        prof.max_ms = max(prof.max_ms, ms);
+    }
+
+private:
+    CLua &vm;
+    const char *name;
+    chrono::steady_clock::time_point start;
+};
+
+string CLua::call_profile_report() const
+{
+    vector<pair<string, call_profile>> profs(call_profiles.begin(),
+                                             call_profiles.end());
+    sort(profs.begin(), profs.end(),
+         [](const pair<string, call_profile> &a,
+            const pair<string, call_profile> &b)
+         {
+             return a.second.total_ms > b.second.total_ms;
+         });
+
+    string report = make_stringf("%-32s %8s %10s %8s\n",
+                                 "Function", "Calls", "Total ms", "Max ms");
+    for (const auto &prof : profs)
+    {
+        report += make_stringf("%-32s %8d %10.2f %8.2f\n",
+                               prof.first.c_str(), prof.second.calls,
+                               prof.second.total_ms, prof.second.max_ms);
+    }
+    return report;
+}
+
 bool CLua::runhook(const char *hook, const char *params, ...)
 {
     error.clear();
+    lua_call_timer timer(*this, hook);
 
     lua_State *ls = state();
     if (!ls)
@@ -556,6 +610,7 @@ maybe_bool CLua::callmbooleanfn(const char *fn, const char *params,
                                 va_list args)
 {
     error.clear();
+    lua_call_timer timer(*this, fn);
     lua_State *ls = state();
     if (!ls)
         return MB_MAYBE;
@@ -589,6 +644,7 @@ maybe_bool CLua::callmbooleanfn(const char *fn, const char *params, ...)
 maybe_bool CLua::callmaybefn(const char *fn, const char *params, va_list args)
 {
     error.clear();
+    lua_call_timer timer(*this, fn);
     lua_State *ls = state();
     if (!ls)
         return MB_MAYBE;
@@ -642,9 +698,17 @@ bool CLua::proc_returns(const char *par) const
 //
 void CLua::pushglobal(const string &name)
 {
-    vector<string> pieces = split_string(".", name);
     lua_State *ls(state());
 
+    // Hooks are almost always plain globals; don't split those.
+    if (!name.empty() && name.find('.') == string::npos)
+    {
+        lua_getglobal(ls, name.c_str());
+        return;
+    }
+
+    vector<string> pieces = split_string(".", name);
+
     if (pieces.empty())
         lua_pushnil(ls);
 
@@ -677,6 +741,7 @@ void CLua::pushglobal(const string &name)
 bool CLua::callfn(const char *fn, const char *params, ...)
 {
     error.clear();
+    lua_call_timer timer(*this, fn);
     lua_State *ls = state();
     if (!ls)
         return false;
@@ -706,6 +771,7 @@ bool CLua::callfn(const char *fn, const char *params, ...)
 bool CLua::callfn(const char *fn, int nargs, int nret)
 {
     error.clear();
+    lua_call_timer timer(*this, fn);
     lua_State *ls = state();
     if (!ls)
         return false;
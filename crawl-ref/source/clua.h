@@ -7,6 +7,7 @@ extern "C" {
 #include <lualib.h>
 }
 
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
 #include <map>
@@ -143,6 +144,18 @@ public:
 
     void print_stack();
 
+    // Calls, total and longest time of each named function or hook called
+    // from C++, collected while profile_calls is set.
+    struct call_profile
+    {
+        call_profile() : calls(0), total_ms(0), max_ms(0) { }
+
+        int calls;
+        double total_ms;
+        double max_ms;
+    };
+    string call_profile_report() const;
+
 public:
     string error;
 
@@ -161,6 +174,9 @@ public:
 
     long memory_used;
 
+    bool profile_calls;
+    map<string, call_profile> call_profiles;
+
     static const int MAX_THROTTLE_SLEEPS = 100;
 
 private:
@@ -667,12 +667,16 @@ void init_element_colours()
                        ));
 }
 
+unsigned int element_colour_count = 0;
+
 int element_colour(int element, bool no_random, const coord_def& loc)
 {
     // pass regular colours through for safety.
     if (!_is_element_colour(element))
         return element;
 
+    element_colour_count++;
+
     // Strip COLFLAGs just in case.
     element &= 0x007f;
 
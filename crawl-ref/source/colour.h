@@ -111,6 +111,9 @@ colour_t make_low_colour(colour_t colour) IMMUTABLE;
 colour_t make_high_colour(colour_t colour) IMMUTABLE;
 int  element_colour(int element, bool no_random = false,
                     const coord_def& loc = coord_def());
+// Counts the elemental colours resolved, so that a caller can tell whether
+// what it drew may look different next frame.
+extern unsigned int element_colour_count;
 int get_disjunct_phase(const coord_def& loc);
 bool get_tornado_phase(const coord_def& loc);
 bool get_orb_phase(const coord_def& loc);
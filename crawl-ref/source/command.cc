@@ -1381,6 +1381,7 @@ int list_wizard_commands(bool do_redraw_screen)
                        "<w>O</w>      measure exploration time\n"
                        "<w>Ctrl-T</w> dungeon (D)Lua interpreter\n"
                        "<w>Ctrl-U</w> client (C)Lua interpreter\n"
+                       "<w>Ctrl-L</w> start/report Lua and turn profile\n"
                        "<w>Ctrl-X</w> Xom effect stats\n"
 #ifdef DEBUG_DIAGNOSTICS
                        "<w>Ctrl-Q</w> make some debug messages quiet\n"
@@ -185,7 +185,9 @@ end
 -- address the map with function calls such as name(), tags(), etc.
 --
 -- This function caches the environments it creates, so that successive runs
--- of Lua chunks from the same map will use the same environment.
+-- of Lua chunks from the same map will use the same environment. Entries of
+-- tab are wrapped the first time the environment looks them up, rather than
+-- all of them every time a chunk runs.
 function dgn_map_meta_wrap(map, tab)
    if not dgn._map_envs then
       dgn._map_envs = { }
@@ -197,24 +199,32 @@ function dgn_map_meta_wrap(map, tab)
    if not meta then
       meta = { }
       dgn_init_hook_tables(meta)
-      local meta_meta = { __index = _G }
+      local meta_meta = {
+        __index = function (env, key)
+                    local val = tab[key]
+                    if val == nil then
+                      return _G[key]
+                    end
+                    local fn = function (...)
+                                 return crawl.err_trace(
+                                   val, rawget(env, 'wrapped_instance'), ...)
+                               end
+                    rawset(env, key, fn)
+                    return fn
+                  end
+      }
       setmetatable(meta, meta_meta)
+      meta['_G'] = meta
       dgn._map_envs[name] = meta
    end
 
    -- We must set this each time - the map may have the same name, but
    -- be a different C++ object.
-   for fn, val in pairs(tab) do
-      meta[fn] = function (...)
-                    return crawl.err_trace(val, map, ...)
-                 end
+   if not rawequal(rawget(meta, 'wrapped_instance'), map) then
+      -- Convenience global variable, e.g. mapgrd[x][y] = 'x'
+      meta['mapgrd'] = dgn.mapgrd_table(map)
+      meta.wrapped_instance = map
    end
-
-   -- Convenience global variable, e.g. mapgrd[x][y] = 'x'
-   meta['mapgrd'] = dgn.mapgrd_table(map)
-
-   meta['_G'] = meta
-   meta.wrapped_instance = map
    return meta
 end
 
@@ -0,0 +1,225 @@
+/**
+ * @file
+ * @brief Timing of the phases of a turn.
+**/
+
+#include "AppHdr.h"
+
+#include "dbg-prof.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include "initfile.h"
+#include "message.h"
+#include "stringutil.h"
+#include "syscalls.h"
+#include "unicode.h"
+
+bool prof_enabled = false;
+
+// Phases are never removed, as PROF_SCOPE sites keep references to them;
+// prof_clear() only zeroes them.
+static map<string, prof_phase> _phases;
+
+prof_phase &prof_get_phase(const string &name)
+{
+    auto it = _phases.find(name);
+    if (it == _phases.end())
+        it = _phases.emplace(name, prof_phase(name)).first;
+    return it->second;
+}
+
+prof_timer::~prof_timer()
+{
+    if (!phase)
+        return;
+
+    const double us = std::chrono::duration<double, std::micro>(
+        clock::now() - start).count();
+    phase->count++;
+    phase->total_us += us;
+    phase->max_us = max(phase->max_us, us);
+
+    int bucket = 0;
+    while (bucket < PROF_BUCKETS - 1 && us >= (double)(1 << bucket))
+        ++bucket;
+    phase->buckets[bucket]++;
+}
+
+void prof_clear()
+{
+    for (auto &entry : _phases)
+    {
+        const string name = entry.second.name;
+        entry.second = prof_phase(name);
+    }
+#if defined(UNIX) && !defined(USE_TILE_LOCAL)
+    console_puttext_stats = puttext_stats();
+#endif
+}
+
+// The time below which the given fraction of a phase's samples fall, to
+// the resolution of the histogram.
+static double _percentile_us(const prof_phase &phase, double fraction)
+{
+    const double wanted = phase.count * fraction;
+    uint64_t seen = 0;
+    for (int i = 0; i < PROF_BUCKETS; ++i)
+    {
+        seen += phase.buckets[i];
+        if (seen >= wanted)
+            return min((double)(1 << i), phase.max_us);
+    }
+    return phase.max_us;
+}
+
+static vector<const prof_phase *> _used_phases()
+{
+    vector<const prof_phase *> phases;
+    for (const auto &entry : _phases)
+        if (entry.second.count)
+            phases.push_back(&entry.second);
+
+    sort(phases.begin(), phases.end(),
+         [](const prof_phase *a, const prof_phase *b)
+         {
+             return a->total_us > b->total_us;
+         });
+    return phases;
+}
+
+string prof_report()
+{
+    string report = make_stringf("%-32s %8s %10s %9s %9s %9s\n",
+                                 "Phase", "Count", "Total ms", "Mean us",
+                                 "p99 us", "Max us");
+    for (const prof_phase *phase : _used_phases())
+    {
+        report += make_stringf("%-32s %8" PRIu64 " %10.2f %9.1f %9.0f %9.0f\n",
+                               phase->name.c_str(), phase->count,
+                               phase->total_us / 1000,
+                               phase->total_us / phase->count,
+                               _percentile_us(*phase, 0.99), phase->max_us);
+    }
+
+#if defined(UNIX) && !defined(USE_TILE_LOCAL)
+    const puttext_stats &out = console_puttext_stats;
+    if (out.cells_written || out.cells_skipped)
+    {
+        report += make_stringf("View cells written %" PRIu64 ", unchanged %"
+                               PRIu64 "; %" PRIu64 " glyph bytes, %" PRIu64
+                               " cursor moves, %" PRIu64 " colour changes\n",
+                               out.cells_written, out.cells_skipped,
+                               out.glyph_bytes, out.cursor_moves,
+                               out.colour_changes);
+    }
+#endif
+    return report;
+}
+
+static string _json_escape(const string &s)
+{
+    string escaped;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+/**
+ * Write the collected timings to a file: JSON if its name ends in ".json",
+ * otherwise CSV. Each phase has its count, total, mean and maximum, and its
+ * histogram of sample counts by power-of-two microsecond buckets.
+ *
+ * @return whether the file could be written.
+ */
+bool prof_dump(const string &filename)
+{
+    FILE *f = fopen_u(filename.c_str(), "w");
+    if (!f)
+        return false;
+
+    const bool json = ends_with(filename, ".json");
+    const vector<const prof_phase *> phases = _used_phases();
+
+    if (json)
+        fprintf(f, "[\n");
+    else
+    {
+        fprintf(f, "phase,count,total_us,mean_us,max_us");
+        for (int i = 0; i < PROF_BUCKETS; ++i)
+            fprintf(f, ",lt_%dus", 1 << i);
+        fprintf(f, "\n");
+    }
+
+    for (size_t n = 0; n < phases.size(); ++n)
+    {
+        const prof_phase &phase = *phases[n];
+        const double mean = phase.total_us / phase.count;
+        if (json)
+        {
+            fprintf(f, "  {\"phase\": \"%s\", \"count\": %" PRIu64 ", "
+                       "\"total_us\": %.1f, \"mean_us\": %.1f, "
+                       "\"max_us\": %.1f, \"histogram\": [",
+                    _json_escape(phase.name).c_str(), phase.count,
+                    phase.total_us, mean, phase.max_us);
+            for (int i = 0; i < PROF_BUCKETS; ++i)
+                fprintf(f, "%s%" PRIu64, i ? ", " : "", phase.buckets[i]);
+            fprintf(f, "]}%s\n", n + 1 < phases.size() ? "," : "");
+        }
+        else
+        {
+            fprintf(f, "\"%s\",%" PRIu64 ",%.1f,%.1f,%.1f",
+                    replace_all(phase.name, "\"", "\"\"").c_str(),
+                    phase.count, phase.total_us, mean, phase.max_us);
+            for (int i = 0; i < PROF_BUCKETS; ++i)
+                fprintf(f, ",%" PRIu64, phase.buckets[i]);
+            fprintf(f, "\n");
+        }
+    }
+
+    if (json)
+        fprintf(f, "]\n");
+    fclose(f);
+    return true;
+}
+
+// Starts timing turn phases, or if already timing them, reports what has
+// been collected (also to the -profile file, if any) and stops.
+void debug_turn_profile()
+{
+    if (!prof_enabled)
+    {
+        prof_clear();
+        prof_enabled = true;
+        mpr("Profiling turn phases; repeat the command for a report.");
+        return;
+    }
+
+    prof_enabled = false;
+    if (_used_phases().empty())
+    {
+        mpr("No turn phases were profiled.");
+        return;
+    }
+
+    for (const string &line : split_string("\n", prof_report()))
+        mprf(MSGCH_DIAGNOSTICS, "%s", line.c_str());
+
+    if (!SysEnv.profile_file.empty() && !prof_dump(SysEnv.profile_file))
+    {
+        mprf(MSGCH_ERROR, "Couldn't write %s.",
+             SysEnv.profile_file.c_str());
+    }
+}
+
+void prof_dump_at_exit()
+{
+    if (!SysEnv.profile_file.empty() && !_phases.empty())
+        prof_dump(SysEnv.profile_file);
+}
@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @brief Timing of the phases of a turn.
+**/
+
+#ifndef DBGPROF_H
+#define DBGPROF_H
+
+#include <chrono>
+
+// Histogram bucket i counts samples shorter than 2^i microseconds; the
+// last also takes everything longer.
+#define PROF_BUCKETS 24
+
+struct prof_phase
+{
+    string   name;
+    uint64_t count = 0;
+    double   total_us = 0;
+    double   max_us = 0;
+    uint64_t buckets[PROF_BUCKETS] = {};
+
+    prof_phase(const string &n) : name(n) { }
+};
+
+// Off unless -profile is given or the profile command is used; a disabled
+// timer costs one test of this flag.
+extern bool prof_enabled;
+
+prof_phase &prof_get_phase(const string &name);
+void prof_clear();
+string prof_report();
+bool prof_dump(const string &filename);
+void prof_dump_at_exit();
+void debug_turn_profile();
+
+// Times its own lifetime into a phase, if profiling was on at its start.
+class prof_timer
+{
+public:
+    prof_timer(prof_phase *p) : phase(p)
+    {
+        if (phase)
+            start = clock::now();
+    }
+    ~prof_timer();
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    prof_phase *phase;
+    clock::time_point start;
+};
+
+#define PROF_CAT_(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT_(a, b)
+
+// Time the rest of the enclosing scope as the named phase. The name must be
+// constant: it is looked up once per call site.
+#define PROF_SCOPE(name)                                                     \
+    static prof_phase &PROF_CAT(_prof_phase_, __LINE__)                      \
+        = prof_get_phase(name);                                              \
+    prof_timer PROF_CAT(_prof_timer_, __LINE__)(                             \
+        prof_enabled ? &PROF_CAT(_prof_phase_, __LINE__) : nullptr)
+
+// As PROF_SCOPE, for a name built at run time, such as a monster's type.
+// The name is only built while profiling.
+#define PROF_SCOPE_NAMED(name_expr)                                          \
+    prof_timer PROF_CAT(_prof_timer_, __LINE__)(                             \
+        prof_enabled ? &prof_get_phase(name_expr) : nullptr)
+
+#endif
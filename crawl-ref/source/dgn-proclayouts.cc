@@ -14,6 +14,31 @@
 #include "perlin.h"
 #include "terrain.h"
 
+void ProceduralLayout::sample_span(const coord_def &p, int len,
+                                   const uint32_t offset,
+                                   vector<ProceduralSample> &out) const
+{
+    for (int i = 0; i < len; ++i)
+        out.push_back((*this)(coord_def(p.x + i, p.y), offset));
+}
+
+// Worley noise for each cell of a span, with coordinates transformed as
+// (x * xscale, y * yscale, z).
+static void _span_noise(const coord_def &p, int len, double xscale,
+                        double yscale, double z,
+                        vector<worley::noise_datum> &noise)
+{
+    vector<double> points(len * 3);
+    for (int i = 0; i < len; ++i)
+    {
+        points[i * 3] = (p.x + i) * xscale;
+        points[i * 3 + 1] = p.y * yscale;
+        points[i * 3 + 2] = z;
+    }
+    noise.resize(len);
+    worley::noise_batch(points.data(), len, noise.data());
+}
+
 static dungeon_feature_type _pick_pseudorandom_wall(uint64_t val)
 {
     static dungeon_feature_type features[] =
@@ -65,22 +90,30 @@ static uint32_t _get_changepoint(const worley::noise_datum &n, const double scal
     return max(1, (int) floor((n.distance[1] - n.distance[0]) * scale) - 5);
 }
 
+static const double WORLEY_LAYOUT_OFFSET_SCALE = 5000.0;
+
+// Which of the layouts a worley cell picks, and the id it is shifted by.
+static uint8_t _worley_layout_choice(const worley::noise_datum &n,
+                                     uint8_t size, uint32_t &id)
+{
+    bool parity = n.id[0] % 4;
+    id = n.id[0] / 4;
+    return parity ? id % size : min(id % size, (id / size) % size);
+}
+
 ProceduralSample
 WorleyLayout::operator()(const coord_def &p, const uint32_t offset) const
 {
-    const double offset_scale = 5000.0;
     double x = p.x / scale;
     double y = p.y / scale;
-    double z = offset / offset_scale;
+    double z = offset / WORLEY_LAYOUT_OFFSET_SCALE;
     worley::noise_datum n = worley::noise(x, y, z + seed);
 
-    const uint32_t changepoint = offset + _get_changepoint(n, offset_scale);
+    const uint32_t changepoint = offset
+        + _get_changepoint(n, WORLEY_LAYOUT_OFFSET_SCALE);
     const uint8_t size = layouts.size();
-    bool parity = n.id[0] % 4;
-    uint32_t id = n.id[0] / 4;
-    const uint8_t choice = parity
-        ? id % size
-        : min(id % size, (id / size) % size);
+    uint32_t id;
+    const uint8_t choice = _worley_layout_choice(n, size, id);
     const coord_def pd = p + id;
     ProceduralSample sample = (*layouts[(choice + seed) % size])(pd, offset);
 
@@ -88,6 +121,48 @@ WorleyLayout::operator()(const coord_def &p, const uint32_t offset) const
                 min(changepoint, sample.changepoint()));
 }
 
+void WorleyLayout::sample_span(const coord_def &p, int len,
+                               const uint32_t offset,
+                               vector<ProceduralSample> &out) const
+{
+    vector<double> points(len * 3);
+    for (int i = 0; i < len; ++i)
+    {
+        points[i * 3] = (p.x + i) / scale;
+        points[i * 3 + 1] = p.y / scale;
+        points[i * 3 + 2] = offset / WORLEY_LAYOUT_OFFSET_SCALE + seed;
+    }
+    vector<worley::noise_datum> noise(len);
+    worley::noise_batch(points.data(), len, noise.data());
+
+    const uint8_t size = layouts.size();
+    vector<ProceduralSample> sub;
+    // Consecutive cells in the same worley cell map to consecutive cells of
+    // the same sub-layout, so hand those over as a single span.
+    int i = 0;
+    while (i < len)
+    {
+        uint32_t id;
+        const uint8_t choice = _worley_layout_choice(noise[i], size, id);
+        int run = 1;
+        while (i + run < len && noise[i + run].id[0] == noise[i].id[0])
+            ++run;
+
+        sub.clear();
+        const coord_def start(p.x + i, p.y);
+        layouts[(choice + seed) % size]->sample_span(start + id, run, offset,
+                                                     sub);
+        for (int j = 0; j < run; ++j)
+        {
+            const uint32_t changepoint = offset
+                + _get_changepoint(noise[i + j], WORLEY_LAYOUT_OFFSET_SCALE);
+            out.emplace_back(coord_def(start.x + j, p.y), sub[j].feat(),
+                             min(changepoint, sub[j].changepoint()));
+        }
+        i += run;
+    }
+}
+
 ProceduralSample
 ChaosLayout::operator()(const coord_def &p, const uint32_t offset) const
 {
@@ -111,13 +186,28 @@ RoilingChaosLayout::operator()(const coord_def &p, const uint32_t offset) const
     return ProceduralSample(p, sample.feat(), min(sample.changepoint(), changepoint));
 }
 
-ProceduralSample
-WastesLayout::operator()(const coord_def &p, const uint32_t offset) const
+void RoilingChaosLayout::sample_span(const coord_def &p, int len,
+                                     const uint32_t offset,
+                                     vector<ProceduralSample> &out) const
+{
+    const double scale = (density - 350) + 4800;
+    vector<worley::noise_datum> noise;
+    _span_noise(p, len, 1.0, 1.0, offset / scale, noise);
+    for (int i = 0; i < len; ++i)
+    {
+        const coord_def c(p.x + i, p.y);
+        const uint32_t changepoint = offset + _get_changepoint(noise[i], scale);
+        ProceduralSample sample
+            = ChaosLayout(noise[i].id[0] + seed, density)(c, offset);
+        out.emplace_back(c, sample.feat(),
+                         min(sample.changepoint(), changepoint));
+    }
+}
+
+static ProceduralSample _wastes_sample(const coord_def &p,
+                                       const uint32_t offset,
+                                       const worley::noise_datum &n)
 {
-    double x = p.x;
-    double y = p.y;
-    double z = offset / 3;
-    worley::noise_datum n = worley::noise(x, y, z);
     const uint32_t changepoint = offset + _get_changepoint(n, 3);
     ProceduralSample sample = ChaosLayout(n.id[0], 10)(p, offset);
     dungeon_feature_type feat = feat_is_solid(sample.feat())
@@ -126,40 +216,113 @@ WastesLayout::operator()(const coord_def &p, const uint32_t offset) const
 }
 
 ProceduralSample
-RiverLayout::operator()(const coord_def &p, const uint32_t offset) const
+WastesLayout::operator()(const coord_def &p, const uint32_t offset) const
+{
+    double x = p.x;
+    double y = p.y;
+    double z = offset / 3;
+    return _wastes_sample(p, offset, worley::noise(x, y, z));
+}
+
+void WastesLayout::sample_span(const coord_def &p, int len,
+                               const uint32_t offset,
+                               vector<ProceduralSample> &out) const
+{
+    vector<worley::noise_datum> noise;
+    _span_noise(p, len, 1.0, 1.0, offset / 3, noise);
+    for (int i = 0; i < len; ++i)
+        out.push_back(_wastes_sample(coord_def(p.x + i, p.y), offset, noise[i]));
+}
+
+static const double RIVER_SCALE = 10000;
+static const double RIVER_SCALAR = 90.0;
+
+static void _river_point(const coord_def &p, uint32_t seed,
+                         const uint32_t offset, double point[3])
+{
+    point[0] = (p.x + perlin::fBM(p.x/4.0, p.y/4.0, seed, 5) * 3)
+               / RIVER_SCALAR;
+    point[1] = (p.y + perlin::fBM(p.x/4.0 + 3.7, p.y/4.0 + 1.9, seed + 4, 5) * 3)
+               / RIVER_SCALAR;
+    point[2] = offset / RIVER_SCALE + seed;
+}
+
+// Whether the river noise puts water at p. If so, feat and changepoint are
+// set.
+static bool _river_feat(const coord_def &p, uint32_t seed,
+                        const uint32_t offset, const worley::noise_datum &n,
+                        dungeon_feature_type &feat, uint32_t &changepoint)
 {
-    const double scale = 10000;
-    const double scalar = 90.0;
-    double x = (p.x + perlin::fBM(p.x/4.0, p.y/4.0, seed, 5) * 3) / scalar;
-    double y = (p.y + perlin::fBM(p.x/4.0 + 3.7, p.y/4.0 + 1.9, seed + 4, 5) * 3) / scalar;
-    worley::noise_datum n = worley::noise(x, y, offset / scale + seed);
-    const uint32_t changepoint = offset + _get_changepoint(n, scale);
     if ((n.id[0] ^ n.id[1] ^ seed) % 4)
-        return layout(p, offset);
+        return false;
 
     double delta = n.distance[1] - n.distance[0];
-    if (delta < 1.5/scalar)
-    {
-        dungeon_feature_type feat = DNGN_SHALLOW_WATER;
-        uint64_t hash = hash3(p.x, p.y, n.id[0] + seed);
-        if (!(hash % 5))
-            feat = DNGN_DEEP_WATER;
-        if (!(hash % 23))
-            feat = DNGN_TREE;
+    if (delta >= 1.5/RIVER_SCALAR)
+        return false;
+
+    changepoint = offset + _get_changepoint(n, RIVER_SCALE);
+    feat = DNGN_SHALLOW_WATER;
+    uint64_t hash = hash3(p.x, p.y, n.id[0] + seed);
+    if (!(hash % 5))
+        feat = DNGN_DEEP_WATER;
+    if (!(hash % 23))
+        feat = DNGN_TREE;
+    return true;
+}
+
+ProceduralSample
+RiverLayout::operator()(const coord_def &p, const uint32_t offset) const
+{
+    double point[3];
+    _river_point(p, seed, offset, point);
+    worley::noise_datum n = worley::noise(point[0], point[1], point[2]);
+    dungeon_feature_type feat;
+    uint32_t changepoint;
+    if (_river_feat(p, seed, offset, n, feat, changepoint))
         return ProceduralSample(p, feat, changepoint);
-    }
     return layout(p, offset);
 }
 
-ProceduralSample
-NewAbyssLayout::operator()(const coord_def &p, const uint32_t offset) const
+void RiverLayout::sample_span(const coord_def &p, int len,
+                              const uint32_t offset,
+                              vector<ProceduralSample> &out) const
+{
+    vector<double> points(len * 3);
+    for (int i = 0; i < len; ++i)
+        _river_point(coord_def(p.x + i, p.y), seed, offset, &points[i * 3]);
+    vector<worley::noise_datum> noise(len);
+    worley::noise_batch(points.data(), len, noise.data());
+
+    // Cells away from the rivers come from the underlying layout; pass
+    // those down in runs.
+    int dry_start = 0;
+    for (int i = 0; i <= len; ++i)
+    {
+        dungeon_feature_type feat = DNGN_UNSEEN;
+        uint32_t changepoint = 0;
+        const coord_def c(p.x + i, p.y);
+        const bool wet = i < len
+                         && _river_feat(c, seed, offset, noise[i], feat,
+                                        changepoint);
+        if (!wet && i < len)
+            continue;
+
+        if (i > dry_start)
+        {
+            layout.sample_span(coord_def(p.x + dry_start, p.y),
+                               i - dry_start, offset, out);
+        }
+        if (wet)
+            out.emplace_back(c, feat, changepoint);
+        dry_start = i + 1;
+    }
+}
+
+static ProceduralSample _new_abyss_sample(const coord_def &p, uint32_t seed,
+                                          const uint32_t offset,
+                                          const worley::noise_datum &noise)
 {
-    const double scale = 1.0 / 3.2;
     uint64_t base = hash3(p.x, p.y, seed);
-    worley::noise_datum noise = worley::noise(
-            p.x * scale,
-            p.y * scale,
-            offset / 1000.0);
     dungeon_feature_type feat = DNGN_FLOOR;
 
     int dist = noise.distance[0] * 100;
@@ -181,6 +344,32 @@ NewAbyssLayout::operator()(const coord_def &p, const uint32_t offset) const
     return ProceduralSample(p, feat, offset + delta);
 }
 
+static const double NEW_ABYSS_SCALE = 1.0 / 3.2;
+
+ProceduralSample
+NewAbyssLayout::operator()(const coord_def &p, const uint32_t offset) const
+{
+    worley::noise_datum noise = worley::noise(
+            p.x * NEW_ABYSS_SCALE,
+            p.y * NEW_ABYSS_SCALE,
+            offset / 1000.0);
+    return _new_abyss_sample(p, seed, offset, noise);
+}
+
+void NewAbyssLayout::sample_span(const coord_def &p, int len,
+                                 const uint32_t offset,
+                                 vector<ProceduralSample> &out) const
+{
+    vector<worley::noise_datum> noise;
+    _span_noise(p, len, NEW_ABYSS_SCALE, NEW_ABYSS_SCALE, offset / 1000.0,
+                noise);
+    for (int i = 0; i < len; ++i)
+    {
+        out.push_back(_new_abyss_sample(coord_def(p.x + i, p.y), seed, offset,
+                                        noise[i]));
+    }
+}
+
 dungeon_feature_type sanitize_feature(dungeon_feature_type feature, bool strict)
 {
     if (feat_is_gate(feature) || feature == DNGN_TELEPORTER)
@@ -273,6 +462,117 @@ LevelLayout::operator()(const coord_def &p, const uint32_t offset) const
     return ProceduralSample(p, feat, offset + 4096);
 }
 
+void LevelLayout::sample_span(const coord_def &p, int len,
+                              const uint32_t offset,
+                              vector<ProceduralSample> &out) const
+{
+    // Holes in the level are filled by the underlying layout, a run at a
+    // time.
+    int hole_start = 0;
+    for (int i = 0; i <= len; ++i)
+    {
+        const coord_def c(p.x + i, p.y);
+        const dungeon_feature_type feat = i < len ? grid(clip(c))
+                                                  : DNGN_UNSEEN;
+        if (feat == DNGN_UNSEEN && i < len)
+            continue;
+
+        if (i > hole_start)
+        {
+            layout.sample_span(coord_def(p.x + hole_start, p.y),
+                               i - hole_start, offset, out);
+        }
+        if (i < len)
+            out.emplace_back(c, feat, offset + 4096);
+        hole_start = i + 1;
+    }
+}
+
+int CachedLayout::_chunk_index(const coord_def &p)
+{
+    return (p.y & (CHUNK_SIZE - 1)) * CHUNK_SIZE + (p.x & (CHUNK_SIZE - 1));
+}
+
+CachedLayout::chunk &CachedLayout::_chunk_at(const coord_def &p,
+                                             const uint32_t offset) const
+{
+    // A whole abyss area is only about a hundred chunks; anything much
+    // beyond that is stale.
+    if (offset != cached_offset || chunks.size() > 1024)
+    {
+        chunks.clear();
+        cached_offset = offset;
+    }
+    return chunks[coord_def(p.x >> CHUNK_SHIFT, p.y >> CHUNK_SHIFT)];
+}
+
+ProceduralSample
+CachedLayout::operator()(const coord_def &p, const uint32_t offset) const
+{
+    chunk &ch = _chunk_at(p, offset);
+    const int i = _chunk_index(p);
+    if (ch.known & (uint64_t(1) << i))
+        return ProceduralSample(p, ch.feat[i], ch.changepoint[i]);
+
+    const ProceduralSample sample = layout(p, offset);
+    ch.feat[i] = sample.feat();
+    ch.changepoint[i] = sample.changepoint();
+    ch.known |= uint64_t(1) << i;
+    return sample;
+}
+
+void CachedLayout::prefetch(const coord_def &p, int len,
+                            const uint32_t offset) const
+{
+    vector<ProceduralSample> samples;
+    int i = 0;
+    while (i < len)
+    {
+        const coord_def c(p.x + i, p.y);
+        chunk &ch = _chunk_at(c, offset);
+        if (ch.known & (uint64_t(1) << _chunk_index(c)))
+        {
+            ++i;
+            continue;
+        }
+
+        // Evaluate the uncached run, up to the edge of this chunk.
+        int run = 1;
+        while (i + run < len
+               && ((c.x + run) & (CHUNK_SIZE - 1))
+               && !(ch.known
+                    & (uint64_t(1) << _chunk_index(c + coord_def(run, 0)))))
+        {
+            ++run;
+        }
+
+        samples.clear();
+        layout.sample_span(c, run, offset, samples);
+        for (int j = 0; j < run; ++j)
+        {
+            const int idx = _chunk_index(c + coord_def(j, 0));
+            ch.feat[idx] = samples[j].feat();
+            ch.changepoint[idx] = samples[j].changepoint();
+            ch.known |= uint64_t(1) << idx;
+        }
+        i += run;
+    }
+}
+
+void CachedLayout::sample_span(const coord_def &p, int len,
+                               const uint32_t offset,
+                               vector<ProceduralSample> &out) const
+{
+    prefetch(p, len, offset);
+    for (int i = 0; i < len; ++i)
+        out.push_back((*this)(coord_def(p.x + i, p.y), offset));
+}
+
+void CachedLayout::clear() const
+{
+    chunks.clear();
+}
+
 ProceduralSample
 NoiseLayout::operator()(const coord_def &p, const uint32_t offset) const
 {
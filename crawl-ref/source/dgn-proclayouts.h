@@ -55,6 +55,12 @@ class ProceduralLayout
     public:
         virtual ProceduralSample operator()(const coord_def &p,
             const uint32_t offset = 0) const = 0;
+        // Append samples for the len cells starting at p and running in
+        // the +x direction to out. Layouts whose per-cell work can be shared
+        // (mostly noise evaluation) override this; the samples must be the
+        // same as those given by operator().
+        virtual void sample_span(const coord_def &p, int len,
+            const uint32_t offset, vector<ProceduralSample> &out) const;
         virtual ~ProceduralLayout() { }
 };
 
@@ -98,6 +104,9 @@ class WorleyLayout : public ProceduralLayout
             seed(_seed), layouts(_layouts), scale(_scale) {}
         ProceduralSample operator()(const coord_def &p,
             const uint32_t offset = 0) const override;
+        void sample_span(const coord_def &p, int len,
+            const uint32_t offset,
+            vector<ProceduralSample> &out) const override;
     private:
         const uint32_t seed;
         const vector<const ProceduralLayout*> layouts;
@@ -130,6 +139,9 @@ class RoilingChaosLayout : public ProceduralLayout
             seed(_seed), density(_density) {}
         ProceduralSample operator()(const coord_def &p,
             const uint32_t offset = 0) const override;
+        void sample_span(const coord_def &p, int len,
+            const uint32_t offset,
+            vector<ProceduralSample> &out) const override;
     private:
         const uint32_t seed;
         const uint32_t density;
@@ -142,6 +154,9 @@ class WastesLayout : public ProceduralLayout
         WastesLayout() { };
         ProceduralSample operator()(const coord_def &p,
             const uint32_t offset = 0) const override;
+        void sample_span(const coord_def &p, int len,
+            const uint32_t offset,
+            vector<ProceduralSample> &out) const override;
 };
 
 class RiverLayout : public ProceduralLayout
@@ -151,6 +166,9 @@ class RiverLayout : public ProceduralLayout
             seed(_seed), layout(_layout) {}
         ProceduralSample operator()(const coord_def &p,
             const uint32_t offset = 0) const override;
+        void sample_span(const coord_def &p, int len,
+            const uint32_t offset,
+            vector<ProceduralSample> &out) const override;
     private:
         const uint32_t seed;
         const ProceduralLayout &layout;
@@ -163,6 +181,9 @@ class NewAbyssLayout : public ProceduralLayout
         NewAbyssLayout(uint32_t _seed) : seed(_seed) {}
         ProceduralSample operator()(const coord_def &p,
             const uint32_t offset = 0) const override;
+        void sample_span(const coord_def &p, int len,
+            const uint32_t offset,
+            vector<ProceduralSample> &out) const override;
     private:
         const uint32_t seed;
 };
@@ -176,6 +197,9 @@ class LevelLayout : public ProceduralLayout
             const ProceduralLayout &_layout);
         ProceduralSample operator()(const coord_def &p,
             const uint32_t offset = 0) const override;
+        void sample_span(const coord_def &p, int len,
+            const uint32_t offset,
+            vector<ProceduralSample> &out) const override;
     private:
         feature_grid grid;
         uint32_t seed;
@@ -201,6 +225,43 @@ class ClampLayout : public ProceduralLayout
         const bool bursty;
 };
 
+// Memoises the samples of another layout at a single offset, in square
+// chunks of cells. Asking for a different offset flushes the cache, so this
+// only pays off for callers sampling many cells at the same depth, like the
+// abyss regenerating an area or working through its morph queue.
+class CachedLayout : public ProceduralLayout
+{
+    public:
+        CachedLayout(const ProceduralLayout &_layout) :
+            layout(_layout), cached_offset(0) {}
+        ProceduralSample operator()(const coord_def &p,
+            const uint32_t offset = 0) const override;
+        void sample_span(const coord_def &p, int len,
+            const uint32_t offset,
+            vector<ProceduralSample> &out) const override;
+        // Evaluate any cells of the span that are not cached yet, in bulk.
+        void prefetch(const coord_def &p, int len,
+            const uint32_t offset) const;
+        void clear() const;
+    private:
+        static const int CHUNK_SHIFT = 3;
+        static const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+        struct chunk
+        {
+            chunk() : known(0) { }
+            uint64_t known;
+            dungeon_feature_type feat[CHUNK_SIZE * CHUNK_SIZE];
+            uint32_t changepoint[CHUNK_SIZE * CHUNK_SIZE];
+        };
+
+        chunk &_chunk_at(const coord_def &p, const uint32_t offset) const;
+        static int _chunk_index(const coord_def &p);
+
+        const ProceduralLayout &layout;
+        mutable uint32_t cached_offset;
+        mutable map<coord_def, chunk> chunks;
+};
+
 // Base class is only needed for a couple of support functions
 // TODO: Refactor those functions into ProceduralFunctions
 
@@ -177,6 +177,19 @@ int dlua_chunk::load(CLua &interp)
     return err;
 }
 
+// Compiles the chunk to bytecode without running it, so that copies of
+// the chunk (and the map cache) can load it without recompiling.
+int dlua_chunk::compile(CLua &interp)
+{
+    if (!compiled.empty() || empty())
+        return 0;
+
+    const int err = load(interp);
+    if (!err)
+        lua_pop(interp, 1);
+    return err;
+}
+
 int dlua_chunk::run(CLua &interp)
 {
     int err = load(interp);
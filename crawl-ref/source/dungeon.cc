@@ -748,50 +748,87 @@ static bool _dgn_square_is_passable(const coord_def &c)
     return !(env.level_map_mask(c) & MMT_OPAQUE) && dgn_square_travel_ok(c);
 }
 
-static inline void _dgn_point_record_stub(const coord_def &) { }
-
-template <class point_record>
-static bool _dgn_fill_zone(
-    const coord_def &start, int zone,
-    point_record &record_point,
-    bool (*passable)(const coord_def &) = _dgn_square_is_passable,
-    bool (*iswanted)(const coord_def &) = nullptr)
-{
-    bool ret = false;
-    list<coord_def> points[2];
-    int cur = 0;
-
-    // No bounds checks, assuming the level has at least one layer of
-    // rock border.
+// Labels each connected zone of passable squares in travel_point_distance,
+// numbering the zones in the order a row-by-row scan first reaches them.
+// Returns the number of zones. If iswanted is given, (*wanted)[zone] says
+// whether any square in that zone satisfies it.
+//
+// This is a two-pass union-find rather than a flood fill per zone, so the
+// whole level costs two passes over the grid however many zones it has.
+static int _dgn_label_zones(bool (*passable)(const coord_def &),
+                            bool (*iswanted)(const coord_def &) = nullptr,
+                            vector<bool> *wanted = nullptr)
+{
+    // Squares are indexed y * GXM + x; a zone's root is its first square
+    // in scan order, and impassable squares have a parent of -1.
+    static int parent[GXM * GYM];
+    static int zone_of[GXM * GYM];
+    auto root = [](int i)
+    {
+        while (parent[i] != i)
+            i = parent[i] = parent[parent[i]];
+        return i;
+    };
 
-    for (points[cur].push_back(start); !points[cur].empty();)
+    // The neighbours the scan has already visited.
+    static const coord_def back[] =
     {
-        for (const auto &c : points[cur])
-        {
-            travel_point_distance[c.x][c.y] = zone;
+        coord_def(-1, 0), coord_def(-1, -1), coord_def(0, -1), coord_def(1, -1)
+    };
 
-            if (iswanted && iswanted(c))
-                ret = true;
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+        {
+            const int i = y * GXM + x;
+            if (!map_bounds(x, y) || !passable(coord_def(x, y)))
+            {
+                parent[i] = -1;
+                continue;
+            }
 
-            for (adjacent_iterator ai(c); ai; ++ai)
+            parent[i] = i;
+            for (const coord_def &d : back)
             {
-                const coord_def& cp = *ai;
-                if (!map_bounds(cp)
-                    || travel_point_distance[cp.x][cp.y] || !passable(cp))
-                {
+                const coord_def n(x + d.x, y + d.y);
+                if (!map_bounds(n) || parent[n.y * GXM + n.x] < 0)
                     continue;
-                }
 
-                travel_point_distance[cp.x][cp.y] = zone;
-                record_point(cp);
-                points[!cur].push_back(cp);
+                const int a = root(i), b = root(n.y * GXM + n.x);
+                if (a != b)
+                    parent[max(a, b)] = min(a, b);
             }
         }
 
-        points[cur].clear();
-        cur = !cur;
+    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
+    int nzones = 0;
+    for (int y = 0; y < GYM; ++y)
+        for (int x = 0; x < GXM; ++x)
+        {
+            const int i = y * GXM + x;
+            if (parent[i] < 0)
+                continue;
+
+            const int r = root(i);
+            if (r == i)
+                zone_of[i] = ++nzones;
+            travel_point_distance[x][y] = zone_of[r];
+        }
+
+    if (wanted)
+    {
+        wanted->assign(nzones + 1, false);
+        if (iswanted)
+        {
+            for (rectangle_iterator ri(0); ri; ++ri)
+            {
+                const int zone = travel_point_distance[ri->x][ri->y];
+                if (zone && !(*wanted)[zone] && iswanted(*ri))
+                    (*wanted)[zone] = true;
+            }
+        }
     }
-    return ret;
+
+    return nzones;
 }
 
 static bool _is_perm_down_stair(const coord_def &c)
@@ -903,68 +940,44 @@ static bool _is_exit_stair(const coord_def &c)
 //
 // If fill is non-zero, it fills any disconnected regions with fill.
 //
-static int _process_disconnected_zones(int x1, int y1, int x2, int y2,
-                                       bool choose_stairless,
+static int _process_disconnected_zones(bool choose_stairless,
                                        dungeon_feature_type fill)
 {
-    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
-    int nzones = 0;
+    vector<bool> has_stair;
+    const int nzones =
+        _dgn_label_zones(_dgn_square_is_passable,
+                         choose_stairless ? (at_branch_bottom() ?
+                                             _is_upwards_exit_stair :
+                                             _is_exit_stair) : nullptr,
+                         &has_stair);
+
+    // If we want only stairless zones, screen out zones that did have
+    // stairs.
     int ngood = 0;
-    for (int y = y1; y <= y2 ; ++y)
+    if (choose_stairless)
+        ngood = count(has_stair.begin(), has_stair.end(), true);
+
+    if (fill)
     {
-        for (int x = x1; x <= x2; ++x)
+        // Don't fill in areas connected to vaults.
+        // We want vaults to be accessible; if the area is disconneted
+        // from the rest of the level, this will cause the level to be
+        // vetoed later on.
+        vector<bool> keep(nzones + 1, false);
+        if (choose_stairless)
+            keep = has_stair;
+        for (rectangle_iterator ri(0); ri; ++ri)
         {
-            if (!map_bounds(x, y)
-                || travel_point_distance[x][y]
-                || !_dgn_square_is_passable(coord_def(x, y)))
-            {
-                continue;
-            }
+            const int zone = travel_point_distance[ri->x][ri->y];
+            if (zone && map_masked(*ri, MMT_VAULT))
+                keep[zone] = true;
+        }
 
-            const bool found_exit_stair =
-                _dgn_fill_zone(coord_def(x, y), ++nzones,
-                               _dgn_point_record_stub,
-                               _dgn_square_is_passable,
-                               choose_stairless ? (at_branch_bottom() ?
-                                                   _is_upwards_exit_stair :
-                                                   _is_exit_stair) : nullptr);
-
-            // If we want only stairless zones, screen out zones that did
-            // have stairs.
-            if (choose_stairless && found_exit_stair)
-                ++ngood;
-            else if (fill)
-            {
-                // Don't fill in areas connected to vaults.
-                // We want vaults to be accessible; if the area is disconneted
-                // from the rest of the level, this will cause the level to be
-                // vetoed later on.
-                bool veto = false;
-                vector<coord_def> coords;
-                for (int fy = y1; fy <= y2 ; ++fy)
-                {
-                    for (int fx = x1; fx <= x2; ++fx)
-                    {
-                        if (travel_point_distance[fx][fy] == nzones)
-                        {
-                            if (map_masked(coord_def(fx, fy), MMT_VAULT))
-                            {
-                                veto = true;
-                                break;
-                            }
-                            else
-                                coords.emplace_back(fx, fy);
-                        }
-                    }
-                    if (veto)
-                        break;
-                }
-                if (!veto)
-                {
-                    for (auto c : coords)
-                        _set_grd(c, fill);
-                }
-            }
+        for (rectangle_iterator ri(0); ri; ++ri)
+        {
+            const int zone = travel_point_distance[ri->x][ri->y];
+            if (zone && !keep[zone])
+                _set_grd(*ri, fill);
         }
     }
 
@@ -974,8 +987,7 @@ static int _process_disconnected_zones(int x1, int y1, int x2, int y2,
 int dgn_count_disconnected_zones(bool choose_stairless,
                                  dungeon_feature_type fill)
 {
-    return _process_disconnected_zones(0, 0, GXM-1, GYM-1, choose_stairless,
-                                       fill);
+    return _process_disconnected_zones(choose_stairless, fill);
 }
 
 static void _fixup_pandemonium_stairs()
@@ -1768,86 +1780,75 @@ static bool _fixup_stone_stairs(bool preserve_vault_stairs)
 static bool _add_feat_if_missing(bool (*iswanted)(const coord_def &),
                                  dungeon_feature_type feat)
 {
-    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
-    int nzones = 0;
-    for (int y = 0; y < GYM; ++y)
-        for (int x = 0; x < GXM; ++x)
-        {
-            // [ds] Use dgn_square_is_passable instead of
-            // dgn_square_travel_ok here, for we'll otherwise
-            // fail on floorless isolated pocket in vaults (like the
-            // altar surrounded by deep water), and trigger the assert
-            // downstairs.
-            const coord_def gc(x, y);
-            if (!map_bounds(x, y)
-                || travel_point_distance[x][y] // already covered previously
-                || !_dgn_square_is_passable(gc))
-            {
-                continue;
-            }
+    // [ds] Use dgn_square_is_passable instead of
+    // dgn_square_travel_ok here, for we'll otherwise
+    // fail on floorless isolated pocket in vaults (like the
+    // altar surrounded by deep water), and trigger the assert
+    // downstairs.
+    vector<bool> has_feat;
+    const int nzones = _dgn_label_zones(_dgn_square_is_passable, iswanted,
+                                        &has_feat);
+    for (int zone = 1; zone <= nzones; ++zone)
+    {
+        if (has_feat[zone])
+            continue;
 
-            if (_dgn_fill_zone(gc, ++nzones, _dgn_point_record_stub,
-                               _dgn_square_is_passable, iswanted))
+        bool found_feature = false;
+        for (rectangle_iterator ri(0); ri; ++ri)
+        {
+            if (grd(*ri) == feat
+                && travel_point_distance[ri->x][ri->y] == zone)
             {
-                continue;
+                found_feature = true;
+                break;
             }
+        }
 
-            bool found_feature = false;
-            for (rectangle_iterator ri(0); ri; ++ri)
-            {
-                if (grd(*ri) == feat
-                    && travel_point_distance[ri->x][ri->y] == nzones)
-                {
-                    found_feature = true;
-                    break;
-                }
-            }
+        if (found_feature)
+            continue;
 
-            if (found_feature)
+        int i = 0;
+        while (i++ < 2000)
+        {
+            coord_def rnd(random2(GXM), random2(GYM));
+            if (grd(rnd) != DNGN_FLOOR)
                 continue;
 
-            int i = 0;
-            while (i++ < 2000)
-            {
-                coord_def rnd(random2(GXM), random2(GYM));
-                if (grd(rnd) != DNGN_FLOOR)
-                    continue;
+            if (travel_point_distance[rnd.x][rnd.y] != zone)
+                continue;
 
-                if (travel_point_distance[rnd.x][rnd.y] != nzones)
-                    continue;
+            _set_grd(rnd, feat);
+            found_feature = true;
+            break;
+        }
 
-                _set_grd(rnd, feat);
-                found_feature = true;
-                break;
-            }
+        if (found_feature)
+            continue;
 
-            if (found_feature)
+        for (rectangle_iterator ri(0); ri; ++ri)
+        {
+            if (grd(*ri) != DNGN_FLOOR)
                 continue;
 
-            for (rectangle_iterator ri(0); ri; ++ri)
-            {
-                if (grd(*ri) != DNGN_FLOOR)
-                    continue;
-
-                if (travel_point_distance[ri->x][ri->y] != nzones)
-                    continue;
+            if (travel_point_distance[ri->x][ri->y] != zone)
+                continue;
 
-                _set_grd(*ri, feat);
-                found_feature = true;
-                break;
-            }
+            _set_grd(*ri, feat);
+            found_feature = true;
+            break;
+        }
 
-            if (found_feature)
-                continue;
+        if (found_feature)
+            continue;
 
 #ifdef DEBUG_DIAGNOSTICS
-            dump_map("debug.map", true, true);
+        dump_map("debug.map", true, true);
 #endif
-            // [ds] Too many normal cases trigger this ASSERT, including
-            // rivers that surround a stair with deep water.
-            // die("Couldn't find region.");
-            return false;
-        }
+        // [ds] Too many normal cases trigger this ASSERT, including
+        // rivers that surround a stair with deep water.
+        // die("Couldn't find region.");
+        return false;
+    }
 
     return true;
 }
@@ -4055,7 +4056,7 @@ static const vault_placement *_build_vault_impl(const map_def *vault,
     if (!build_only && (placed_vault_orientation != MAP_ENCOMPASS || is_layout)
         && player_in_branch(BRANCH_SWAMP))
     {
-        _process_disconnected_zones(0, 0, GXM-1, GYM-1, true, DNGN_TREE);
+        _process_disconnected_zones(true, DNGN_TREE);
     }
 
     if (!make_no_exits)
@@ -6152,20 +6153,7 @@ static bool _fixup_interlevel_connectivity()
     has_down[0] = has_down[1] = has_down[2] = false;
 
     // Find up stairs and down stairs on the current level.
-    memset(travel_point_distance, 0, sizeof(travel_distance_grid_t));
-    int nzones = 0;
-    for (rectangle_iterator ri(0); ri; ++ri)
-    {
-        if (!map_bounds(ri->x, ri->y)
-            || travel_point_distance[ri->x][ri->y]
-            || !dgn_square_travel_ok(*ri))
-        {
-            continue;
-        }
-
-        _dgn_fill_zone(*ri, ++nzones, _dgn_point_record_stub,
-                       dgn_square_travel_ok, nullptr);
-    }
+    _dgn_label_zones(dgn_square_travel_ok);
 
     int max_region = 0;
     for (rectangle_iterator ri(0); ri; ++ri)
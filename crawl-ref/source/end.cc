@@ -14,6 +14,7 @@
 #include "colour.h"
 #include "crash.h"
 #include "database.h"
+#include "dbg-prof.h"
 #include "describe.h"
 #include "dungeon.h"
 #include "godpassive.h"
@@ -145,6 +146,7 @@ NORETURN void end(int exit_code, bool print_error, const char *format, ...)
 
         cio_cleanup();
         msg::deinitialise_mpr_streams();
+        prof_dump_at_exit();
         _clear_globals_on_exit();
         databaseSystemShutdown();
 #ifdef DEBUG_PROPS
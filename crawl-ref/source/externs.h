@@ -638,6 +638,9 @@ public:
     bool is_mundane() const;
 
 private:
+    string name_uncached(description_level_type descrip, bool terse,
+                         bool ident, bool with_inscription,
+                         bool quantity_in_words, iflags_t ignore_flags) const;
     string name_aux(description_level_type desc, bool terse, bool ident,
                     bool with_inscription, iflags_t ignore_flags) const;
 
@@ -34,6 +34,7 @@
 #include "cloud.h"
 #include "coordit.h"
 #include "dactions.h"
+#include "dbg-prof.h"
 #include "dgn-overview.h"
 #include "directn.h"
 #include "dungeon.h"
@@ -1604,6 +1605,7 @@ static void _save_game_exit()
 
 void save_game(bool leave_game, const char *farewellmsg)
 {
+    PROF_SCOPE("save_game");
     unwind_bool saving_game(crawl_state.saving_game, true);
 
 
@@ -26,6 +26,7 @@
 #include "defines.h"
 #include "delay.h"
 #include "directn.h"
+#include "dbg-prof.h"
 #include "dlua.h"
 #include "end.h"
 #include "errors.h"
@@ -1149,6 +1150,7 @@ void game_options::reset_options()
     sound_mappings.clear();
     menu_colour_mappings.clear();
     message_colour_mappings.clear();
+    generation++;
     named_options.clear();
 
     clear_cset_overrides();
@@ -1707,7 +1709,8 @@ void read_options(const string &s, bool runscript, bool clear_aliases)
 }
 
 game_options::game_options()
-    : seed(0), no_save(false), language(LANG_EN), lang_name(nullptr)
+    : seed(0), no_save(false), language(LANG_EN), lang_name(nullptr),
+      generation(0)
 {
     reset_options();
 }
@@ -2462,6 +2465,10 @@ void game_options::read_option_line(const string &str, bool runscript)
     lowercase(trim_string(key));
     lowercase(trim_string(subkey));
 
+    // Any option line may touch the lists that have caches built from them,
+    // through aliases if not directly; the caches are rebuilt lazily.
+    generation++;
+
     // some fields want capitals... none care about external spaces
     trim_string(field);
 
@@ -3713,6 +3720,9 @@ enum commandline_option_type
     CLO_NO_GDB, CLO_NOGDB,
     CLO_THROTTLE,
     CLO_NO_THROTTLE,
+    CLO_RECORD_KEYS,
+    CLO_REPLAY_KEYS,
+    CLO_PROFILE,
     CLO_PLAYABLE_JSON, // JSON metadata for species, jobs, combos.
 #ifdef USE_TILE_WEB
     CLO_WEBTILES_SOCKET,
@@ -3732,7 +3742,7 @@ static const char *cmd_ops[] =
     "extra-opt-first", "extra-opt-last", "sprint-map", "edit-save",
     "print-charset", "tutorial", "wizard", "explore", "no-save",
     "gdb", "no-gdb", "nogdb", "throttle", "no-throttle",
-    "playable-json",
+    "record-keys", "replay-keys", "profile", "playable-json",
 #ifdef USE_TILE_WEB
     "webtiles-socket", "await-connection", "print-webtiles-options",
 #endif
@@ -4588,6 +4598,25 @@ bool parse_args(int argc, char **argv, bool rc_only)
             crawl_state.throttle = false;
             break;
 
+        case CLO_RECORD_KEYS:
+        case CLO_REPLAY_KEYS:
+            if (!next_is_param)
+                return false;
+
+            (o == CLO_RECORD_KEYS ? SysEnv.keylog_record
+                                  : SysEnv.keylog_replay) = next_arg;
+            nextUsed = true;
+            break;
+
+        case CLO_PROFILE:
+            if (!next_is_param)
+                return false;
+
+            SysEnv.profile_file = next_arg;
+            prof_enabled = true;
+            nextUsed = true;
+            break;
+
         case CLO_EXTRA_OPT_FIRST:
             if (!next_is_param)
                 return false;
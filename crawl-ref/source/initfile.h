@@ -62,6 +62,10 @@ public:
     vector<string> extra_opts_first;
     vector<string> extra_opts_last;
 
+    string keylog_record;          // Keystroke log to write.
+    string keylog_replay;          // Keystroke log to play back.
+    string profile_file;           // Where to write turn phase timings.
+
 public:
     void add_rcdir(const string &dir);
 };
@@ -130,9 +130,99 @@ static string _item_inscription(const item_def &item)
                                              ", ").c_str());
 }
 
+// Everything about a call to item_def::name() that the result depends on,
+// other than player and game state; that is covered by the generation the
+// cache was filled in.
+struct item_name_key
+{
+    description_level_type descrip;
+    bool terse, ident, with_inscription, quantity_in_words;
+    iflags_t ignore_flags;
+
+    object_class_type base_type;
+    uint8_t sub_type;
+    short plus, plus2;
+    int special;
+    uint8_t rnd;
+    short quantity;
+    iflags_t flags;
+    coord_def pos;
+    short link;
+    // Props that names read, such as an artefact's known properties, are
+    // only changed in ways that also invalidate the cache or add a key.
+    unsigned int nprops;
+    string inscription;
+
+    bool operator<(const item_name_key &o) const
+    {
+        return tie(descrip, terse, ident, with_inscription, quantity_in_words,
+                   ignore_flags, base_type, sub_type, plus, plus2, special,
+                   rnd, quantity, flags, pos, link, nprops, inscription)
+               < tie(o.descrip, o.terse, o.ident, o.with_inscription,
+                     o.quantity_in_words, o.ignore_flags, o.base_type,
+                     o.sub_type, o.plus, o.plus2, o.special, o.rnd,
+                     o.quantity, o.flags, o.pos, o.link, o.nprops,
+                     o.inscription);
+    }
+};
+
+// Names built since the player or game state they depend on last changed.
+// Menus, stash searches and webtiles inventory updates ask for the same
+// names many times over between turns.
+static map<item_name_key, string> _item_names;
+static unsigned int _item_names_options = 0;
+static const size_t ITEM_NAME_CACHE_SIZE = 4096;
+
+/**
+ * Forget all memoised item names. Call this when anything outside an item
+ * that its name depends on changes: the turn passing, item types being
+ * identified, artefact properties being learned or equipment changing.
+ */
+void invalidate_item_names()
+{
+    _item_names.clear();
+}
+
 string item_def::name(description_level_type descrip, bool terse, bool ident,
                       bool with_inscription, bool quantity_in_words,
                       iflags_t ignore_flags) const
+{
+    // Equipment descriptions depend on the quiver and the player's body.
+    if (descrip == DESC_NONE || descrip == DESC_INVENTORY_EQUIP)
+    {
+        return name_uncached(descrip, terse, ident, with_inscription,
+                             quantity_in_words, ignore_flags);
+    }
+
+    if (_item_names_options != Options.generation)
+    {
+        _item_names.clear();
+        _item_names_options = Options.generation;
+    }
+
+    const item_name_key key =
+    {
+        descrip, terse, ident, with_inscription, quantity_in_words,
+        ignore_flags, base_type, sub_type, plus, plus2, special, rnd,
+        quantity, flags, pos, link, props.size(), inscription
+    };
+
+    auto cached = _item_names.find(key);
+    if (cached != _item_names.end())
+        return cached->second;
+
+    if (_item_names.size() >= ITEM_NAME_CACHE_SIZE)
+        _item_names.clear();
+
+    return _item_names[key] = name_uncached(descrip, terse, ident,
+                                            with_inscription,
+                                            quantity_in_words, ignore_flags);
+}
+
+string item_def::name_uncached(description_level_type descrip, bool terse,
+                               bool ident, bool with_inscription,
+                               bool quantity_in_words,
+                               iflags_t ignore_flags) const
 {
     if (crawl_state.game_is_arena())
     {
@@ -2132,6 +2222,7 @@ bool set_ident_type(object_class_type basetype, int subtype, bool identify)
         return false;
 
     you.type_ids[basetype][subtype] = identify;
+    invalidate_item_names();
     request_autoinscribe();
 
     // Our item knowledge changed in a way that could possibly affect shop
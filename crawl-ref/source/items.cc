@@ -2866,6 +2866,53 @@ static int _autopickup_subtype(const item_def &item)
     }
 }
 
+// Explore and travel ask about the same floor items every turn, so the
+// result of matching autopickup_exceptions is remembered per item name.
+// The name reflects the item's identification state, so identifying it
+// gives a fresh lookup; the whole cache is dropped when the options change.
+static map<string, maybe_bool> _autopickup_exception_cache;
+static text_pattern_union _autopickup_exception_patterns;
+static bool _autopickup_exception_loose = false;
+static unsigned int _autopickup_exception_generation = 0;
+
+static const size_t AUTOPICKUP_EXCEPTION_CACHE_SIZE = 2048;
+
+static maybe_bool _autopickup_exception(const string &iname)
+{
+    if (_autopickup_exception_generation != Options.generation)
+    {
+        _autopickup_exception_cache.clear();
+        _autopickup_exception_patterns.clear();
+        _autopickup_exception_loose = false;
+        for (const pair<text_pattern, bool>& option : Options.force_autopickup)
+            if (!_autopickup_exception_patterns.add(option.first))
+                _autopickup_exception_loose = true;
+        _autopickup_exception_generation = Options.generation;
+    }
+
+    auto cached = _autopickup_exception_cache.find(iname);
+    if (cached != _autopickup_exception_cache.end())
+        return cached->second;
+
+    maybe_bool result = MB_MAYBE;
+    if (_autopickup_exception_loose
+        || _autopickup_exception_patterns.matches(iname))
+    {
+        for (const pair<text_pattern, bool>& option : Options.force_autopickup)
+        {
+            if (option.first.matches(iname))
+            {
+                result = option.second ? MB_TRUE : MB_FALSE;
+                break;
+            }
+        }
+    }
+
+    if (_autopickup_exception_cache.size() >= AUTOPICKUP_EXCEPTION_CACHE_SIZE)
+        _autopickup_exception_cache.clear();
+    return _autopickup_exception_cache[iname] = result;
+}
+
 static bool _is_option_autopickup(const item_def &item, bool ignore_force)
 {
     string iname = _autopickup_item_name(item);
@@ -2896,9 +2943,9 @@ static bool _is_option_autopickup(const item_def &item, bool ignore_force)
 #endif
 
     // Check for initial settings
-    for (const pair<text_pattern, bool>& option : Options.force_autopickup)
-        if (option.first.matches(iname))
-            return option.second;
+    const maybe_bool forced = _autopickup_exception(iname);
+    if (forced != MB_MAYBE)
+        return forced == MB_TRUE;
 
     return Options.autopickups[item.base_type];
 }
@@ -32,6 +32,7 @@
 
 #include "cio.h"
 #include "crash.h"
+#include "options.h"
 #include "state.h"
 #include "unicode.h"
 #include "view.h"
@@ -66,6 +67,43 @@ static int curs_bg_attr(int col);
 
 static bool cursor_is_enabled = true;
 
+puttext_stats console_puttext_stats;
+
+// What puttext() last wrote, so that the next call need only write the
+// cells that have changed. Rows that anything else writes over are marked
+// stale and rewritten whole; clearing the screen forgets the lot.
+struct shadow_cell
+{
+    char32_t glyph;
+    unsigned short colour;
+};
+
+static vector<shadow_cell> _shadow;
+static vector<bool> _shadow_stale;
+static coord_def _shadow_pos;       // in curses coordinates
+static coord_def _shadow_size;
+static unsigned int _shadow_generation;
+
+static void _forget_shadow()
+{
+    _shadow.clear();
+    _shadow_stale.clear();
+}
+
+// Marks stale the shadow row at curses row y, if [x1, x2) overlaps it.
+static void _shadow_touch(int y, int x1, int x2)
+{
+    if (_shadow.empty())
+        return;
+
+    const int row = y - _shadow_pos.y;
+    if (row >= 0 && row < _shadow_size.y
+        && x1 < _shadow_pos.x + _shadow_size.x && x2 > _shadow_pos.x)
+    {
+        _shadow_stale[row] = true;
+    }
+}
+
 static unsigned int convert_to_curses_attr(int chattr)
 {
     switch (chattr & CHATTR_ATTRMASK)
@@ -445,6 +483,7 @@ void console_startup()
     crawl_view.init_geometry();
 
     set_mouse_enabled(false);
+    _forget_shadow();
 
 #ifdef USE_TILE_WEB
     tiles.resize();
@@ -486,7 +525,7 @@ void cprintf(const char *format, ...)
     }
 }
 
-void putwch(char32_t chr)
+static void _put_wch(char32_t chr)
 {
     wchar_t c = chr;
     if (!c)
@@ -502,18 +541,77 @@ void putwch(char32_t chr)
 #endif
 }
 
+void putwch(char32_t chr)
+{
+    const int x = getcurx(stdscr);
+    _shadow_touch(getcury(stdscr), x, x + 1);
+    _put_wch(chr);
+}
+
+// Writes only the cells that differ from what the last call with the same
+// position and size wrote, moving the cursor and setting the colour only
+// when the next cell written needs it.
 void puttext(int x1, int y1, const crawl_view_buffer &vbuf)
 {
     const screen_cell_t *cell = vbuf;
     const coord_def size = vbuf.size();
+
+    cgotoxy(x1, y1);
+    const coord_def pos(getcurx(stdscr), getcury(stdscr));
+    // The web console is drawn from its own copy of the text.
+    if (is_tiles() || _shadow.empty() || pos != _shadow_pos
+        || size != _shadow_size || _shadow_generation != Options.generation)
+    {
+        _shadow.assign(size.x * size.y, shadow_cell());
+        _shadow_stale.assign(size.y, true);
+        _shadow_pos = pos;
+        _shadow_size = size;
+        _shadow_generation = Options.generation;
+    }
+
+    puttext_stats &stats = console_puttext_stats;
+    shadow_cell *shadow = &_shadow[0];
+    coord_def cursor(0, 0);
+    int colour = -1;
     for (int y = 0; y < size.y; ++y)
     {
-        cgotoxy(x1, y1 + y);
-        for (int x = 0; x < size.x; ++x)
+        bool stale = _shadow_stale[y] || is_tiles();
+        bool stale_next = false;
+        for (int x = 0; x < size.x; ++x, ++cell, ++shadow)
         {
-            put_colour_ch(cell->colour, cell->glyph);
-            cell++;
+            if (!stale && shadow->glyph == cell->glyph
+                && shadow->colour == cell->colour)
+            {
+                stats.cells_skipped++;
+                continue;
+            }
+
+            if (cursor != coord_def(x, y))
+            {
+                cgotoxy(x1 + x, y1 + y);
+                stats.cursor_moves++;
+            }
+            if (cell->colour != colour)
+            {
+                textcolour(colour = cell->colour);
+                stats.colour_changes++;
+            }
+            _put_wch(cell->glyph);
+            cursor = coord_def(x + 1, y);
+
+            // A glyph that isn't one column wide shifts the rest of the row,
+            // which must then be written out in full, as before.
+            if (cell->glyph && wcwidth(cell->glyph) != 1)
+                stale = stale_next = true;
+
+            char utf8[4];
+            stats.glyph_bytes += wctoutf8(utf8, cell->glyph ? cell->glyph
+                                                            : ' ');
+            stats.cells_written++;
+            shadow->glyph = cell->glyph;
+            shadow->colour = cell->colour;
         }
+        _shadow_stale[y] = stale_next;
     }
     update_screen();
 }
@@ -534,6 +632,7 @@ void update_screen()
 
 void clear_to_end_of_line()
 {
+    _shadow_touch(getcury(stdscr), getcurx(stdscr), COLS);
     textcolour(LIGHTGREY);
     textbackground(BLACK);
     clrtoeol();
@@ -563,6 +662,7 @@ void clrscr()
     textcolour(LIGHTGREY);
     textbackground(BLACK);
     clear();
+    _forget_shadow();
 #ifdef DGAMELAUNCH
     printf("%s", DGL_CLEAR_SCREEN);
     fflush(stdout);
@@ -761,6 +861,7 @@ static inline bool valid_char(const cchar_t &c)
 
 static inline void write_char_at(int y, int x, const cchar_t &ch)
 {
+    _shadow_touch(y, x, x + 1);
     move(y, x);
     add_wchnstr(&ch, 1);
 }
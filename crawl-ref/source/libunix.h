@@ -13,6 +13,19 @@
 
 void fakecursorxy(int x, int y);
 
+// What puttext() has sent to curses, and what it found unchanged and left
+// alone. glyph_bytes counts the UTF-8 encoding of the glyphs written,
+// before curses adds its own cursor and attribute sequences.
+struct puttext_stats
+{
+    uint64_t cells_written = 0;
+    uint64_t cells_skipped = 0;
+    uint64_t glyph_bytes = 0;
+    uint64_t cursor_moves = 0;
+    uint64_t colour_changes = 0;
+};
+extern puttext_stats console_puttext_stats;
+
 #ifdef USE_TILE_WEB
 bool is_tiles();
 #else
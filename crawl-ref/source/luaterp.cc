@@ -20,6 +20,7 @@
 #include "dlua.h"
 #include "message.h"
 #include "options.h"
+#include "stringutil.h"
 
 static int _incomplete(lua_State *ls, int status)
 {
@@ -155,3 +156,26 @@ void debug_terp_dlua(CLua &vm)
     }
     _run_dlua_interpreter(vm);
 }
+
+// Starts profiling the calls C++ makes into the VM's Lua, or if it is
+// already profiling, reports what it has collected and stops.
+void debug_lua_profile(CLua &vm)
+{
+    if (!vm.profile_calls)
+    {
+        vm.call_profiles.clear();
+        vm.profile_calls = true;
+        mpr("Profiling Lua calls; repeat the command for a report.");
+        return;
+    }
+
+    vm.profile_calls = false;
+    if (vm.call_profiles.empty())
+    {
+        mpr("No Lua calls were profiled.");
+        return;
+    }
+
+    for (const string &line : split_string("\n", vm.call_profile_report()))
+        mprf(MSGCH_DIAGNOSTICS, "%s", line.c_str());
+}
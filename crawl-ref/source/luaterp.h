@@ -5,6 +5,7 @@
 #include "dlua.h"
 
 void debug_terp_dlua(CLua &vm = dlua);
+void debug_lua_profile(CLua &vm);
 bool luaterp_running();
 
 #endif
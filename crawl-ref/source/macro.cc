@@ -23,6 +23,7 @@
 #include "macro.h"
 
 #include <cctype>
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <deque>
@@ -32,17 +33,21 @@
 #include <vector>
 
 #include "cio.h"
+#include "end.h"
 #include "files.h"
+#include "hash.h"
 #include "initfile.h"
 #include "libutil.h"
 #include "message.h"
 #include "misc.h" // erase_val
 #include "options.h"
 #include "output.h"
+#include "player.h"
 #include "state.h"
 #include "state.h"
 #include "stringutil.h"
 #include "syscalls.h"
+#include "tags.h"
 #include "unicode.h"
 #include "version.h"
 
@@ -703,6 +708,192 @@ void macro_save()
     fclose(f);
 }
 
+///////////////////////////////////////////////////////////////
+// Keystroke logs
+//
+// -record-keys writes the seed and every batch of keys read from the
+// keyboard to a file, with a hash of the level and player every
+// KEYLOG_CHECK_TURNS turns. -replay-keys feeds such a log back in place of
+// the keyboard, checks the hashes as it goes, and when the keys run out
+// exits with a report of how long the turns took. A log should start from
+// the title screen of a new game, since saves, bones and real time are not
+// part of it.
+
+#define KEYLOG_CHECK_TURNS 100
+
+typedef chrono::steady_clock keylog_clock;
+
+static FILE *keylog_out = nullptr;
+
+static struct
+{
+    bool active = false;
+    string filename;
+    deque<keyseq> keys;
+    map<int, uint32_t> checks; // num_turns -> expected hash
+    int checked = 0;
+
+    keylog_clock::time_point start, last_turn;
+    int turns = 0;
+    double max_ms = 0;
+    int slowest_turn = 0;
+} keylog_replay;
+
+// A hash of the game state that a faithful replay must reproduce.
+static uint32_t _keylog_state_hash()
+{
+    vector<unsigned char> buf;
+    writer th(&buf);
+    tag_write(TAG_LEVEL, th);
+    marshallInt(th, you.num_turns);
+    marshallInt(th, you.elapsed_time);
+    marshallCoord(th, you.pos());
+    marshallInt(th, you.hp);
+    marshallInt(th, you.experience);
+    marshallInt(th, you.gold);
+    marshallString(th, level_id::current().describe());
+    return hash32(buf.data(), buf.size());
+}
+
+void keylog_start_recording(const string &filename)
+{
+    keylog_out = fopen_u(filename.c_str(), "w");
+    if (!keylog_out)
+        end(1, true, "Can't write keystroke log %s", filename.c_str());
+
+    // Without a fixed seed there is nothing to replay.
+    if (!Options.seed && !read_urandom((char*)&Options.seed,
+                                       sizeof(Options.seed)))
+    {
+        Options.seed = time(nullptr);
+    }
+
+    fprintf(keylog_out, "# %s %s keystroke log\n", CRAWL,
+            Version::Long);
+    fprintf(keylog_out, "# rc: %s\n", Options.filename.c_str());
+    fprintf(keylog_out, "seed %x\n", Options.seed);
+    fflush(keylog_out);
+}
+
+void keylog_start_replay(const string &filename)
+{
+    FILE *f = fopen_u(filename.c_str(), "r");
+    if (!f)
+        end(1, true, "Can't read keystroke log %s", filename.c_str());
+
+    char buf[4096];
+    int line = 0;
+    while (fgets(buf, sizeof buf, f))
+    {
+        ++line;
+        vector<string> words = split_string(" ", buf);
+        if (words.empty() || words[0][0] == '#')
+            continue;
+
+        bool ok = true;
+        if (words[0] == "seed" && words.size() == 2)
+            ok = sscanf(words[1].c_str(), "%x", &Options.seed) == 1;
+        else if (words[0] == "keys")
+        {
+            keyseq keys;
+            for (size_t i = 1; i < words.size(); ++i)
+                keys.push_back(atoi(words[i].c_str()));
+            keylog_replay.keys.push_back(keys);
+        }
+        else if (words[0] == "check" && words.size() == 3)
+        {
+            keylog_replay.checks[atoi(words[1].c_str())]
+                = strtoul(words[2].c_str(), nullptr, 16);
+        }
+        else
+            ok = false;
+
+        if (!ok)
+        {
+            fclose(f);
+            end(1, false, "%s:%d: bad keystroke log line", filename.c_str(),
+                line);
+        }
+    }
+    fclose(f);
+
+    keylog_replay.active = true;
+    keylog_replay.filename = filename;
+    keylog_replay.start = keylog_replay.last_turn = keylog_clock::now();
+}
+
+NORETURN static void _keylog_replay_done()
+{
+    const double total_ms = chrono::duration<double, milli>(
+        keylog_clock::now() - keylog_replay.start).count();
+    const int turns = keylog_replay.turns;
+
+    end(0, false,
+        "Replayed %s: %d turns in %.1f ms (%.3f ms/turn, slowest %.3f ms on"
+        " turn %d); %d of %u checks passed; final state hash %08x\n",
+        keylog_replay.filename.c_str(), turns, total_ms,
+        turns ? total_ms / turns : 0.0, keylog_replay.max_ms,
+        keylog_replay.slowest_turn, keylog_replay.checked,
+        (unsigned int)keylog_replay.checks.size(), _keylog_state_hash());
+}
+
+static keyseq _keylog_replay_keys()
+{
+    if (keylog_replay.keys.empty())
+        _keylog_replay_done();
+
+    keyseq keys = keylog_replay.keys.front();
+    keylog_replay.keys.pop_front();
+    return keys;
+}
+
+static void _keylog_record_keys(const keyseq &keys)
+{
+    fprintf(keylog_out, "keys");
+    for (int key : keys)
+        fprintf(keylog_out, " %d", key);
+    fprintf(keylog_out, "\n");
+    fflush(keylog_out);
+}
+
+// Called by world_reacts() at the end of every turn.
+void keylog_turn_done()
+{
+    if (keylog_out && you.num_turns % KEYLOG_CHECK_TURNS == 0)
+    {
+        fprintf(keylog_out, "check %d %08x\n", you.num_turns,
+                _keylog_state_hash());
+        fflush(keylog_out);
+    }
+
+    if (!keylog_replay.active)
+        return;
+
+    const keylog_clock::time_point now = keylog_clock::now();
+    const double ms = chrono::duration<double, milli>(
+        now - keylog_replay.last_turn).count();
+    keylog_replay.last_turn = now;
+    keylog_replay.turns++;
+    if (ms > keylog_replay.max_ms)
+    {
+        keylog_replay.max_ms = ms;
+        keylog_replay.slowest_turn = you.num_turns;
+    }
+
+    auto check = keylog_replay.checks.find(you.num_turns);
+    if (check == keylog_replay.checks.end())
+        return;
+
+    const uint32_t hash = _keylog_state_hash();
+    if (hash != check->second)
+    {
+        end(1, false, "Replay of %s diverged at turn %d: state hash %08x,"
+            " expected %08x", keylog_replay.filename.c_str(), you.num_turns,
+            hash, check->second);
+    }
+    keylog_replay.checked++;
+}
+
 /*
  * Reads as many keypresses as are available (waiting for at least one),
  * and returns them as a single keyseq.
@@ -712,6 +903,9 @@ static keyseq _getch_mul(int (*rgetch)() = nullptr)
     keyseq keys;
     int    a;
 
+    if (keylog_replay.active)
+        return _keylog_replay_keys();
+
     // Something's gone wrong with replaying keys if crawl needs to
     // get new keys from the user.
     if (crawl_state.is_replaying_keys())
@@ -734,6 +928,9 @@ static keyseq _getch_mul(int (*rgetch)() = nullptr)
     }
     while (keys.size() == 0 || ((kbhit() || a == 0) && a != CK_REDRAW));
 
+    if (keylog_out)
+        _keylog_record_keys(keys);
+
     return keys;
 }
 
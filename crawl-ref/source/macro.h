@@ -77,6 +77,11 @@ string get_userfunction(int key);
 void add_key_recorder(key_recorder* recorder);
 void remove_key_recorder(key_recorder* recorder);
 
+// Keystroke logs, for replaying whole sessions as benchmarks.
+void keylog_start_recording(const string &filename);
+void keylog_start_replay(const string &filename);
+void keylog_turn_done();
+
 bool is_processing_macro();
 bool has_pending_input();
 
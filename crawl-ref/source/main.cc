@@ -53,6 +53,7 @@
 #include "crash.h"
 #include "dactions.h"
 #include "database.h"
+#include "dbg-prof.h"
 #include "dbg-scan.h"
 #include "dbg-util.h"
 #include "delay.h"
@@ -317,6 +318,11 @@ int main(int argc, char *argv[])
     // Now parse the args again, looking for everything else.
     parse_args(argc, argv, false);
 
+    if (!SysEnv.keylog_replay.empty())
+        keylog_start_replay(SysEnv.keylog_replay);
+    else if (!SysEnv.keylog_record.empty())
+        keylog_start_recording(SysEnv.keylog_record);
+
     if (Options.sc_entries != 0 || !SysEnv.scorefile.empty())
     {
         crawl_state.type = Options.game.type;
@@ -529,6 +535,12 @@ static void _show_commandline_options_help()
 #else
     puts("  -throttle             enable throttling of user Lua scripts");
 #endif
+    puts("  -record-keys <file>   log the seed and every key pressed to <file>");
+    puts("  -replay-keys <file>   replay a key log at full speed and report"
+         " timings");
+    puts("  -profile <file>       time turn phases, writing them to <file>"
+         " (CSV, or JSON");
+    puts("                        if <file> ends in .json) on exit");
 
     puts("");
 
@@ -795,7 +807,10 @@ static void _do_wizard_command(int wiz_command)
 
     case 'l': wizard_set_xl(); break;
     case 'L': debug_place_map(false); break;
-    // case CONTROL('L'): break;
+    case CONTROL('L'):
+        debug_lua_profile(clua);
+        debug_turn_profile();
+        break;
 
     case 'M':
     case 'm': wizard_create_spec_monster_name(); break;
@@ -2508,9 +2523,13 @@ static void _update_still_winds()
 
 void world_reacts()
 {
+    PROF_SCOPE("world_reacts");
     // All markers should be activated at this point.
     ASSERT(!env.markers.need_activate());
 
+    // Corpses rot, evokers recharge and so on.
+    invalidate_item_names();
+
     fire_final_effects();
 
     if (crawl_state.viewport_monster_hp || crawl_state.viewport_weapons)
@@ -2608,6 +2627,7 @@ void world_reacts()
         update_turn_count();
         msgwin_new_turn();
         crawl_state.lua_calls_no_turn = 0;
+        keylog_turn_done();
         if (crawl_state.game_is_sprint()
             && !(you.num_turns % 256)
             && !you_are_delayed()
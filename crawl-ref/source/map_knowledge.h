@@ -200,6 +200,12 @@ struct map_cell
         _mons = new monster_info(mi);
     }
 
+    void set_monster(monster_info&& mi)
+    {
+        clear_monster();
+        _mons = new monster_info(move(mi));
+    }
+
     bool detected_monster() const
     {
         return !!(flags & MAP_DETECTED_MONSTER);
@@ -430,7 +430,7 @@ bool level_range::valid() const
 // map_lines
 
 map_lines::map_lines()
-    : markers(), lines(), overlay(),
+    : markers(), cells(), map_height(0), overlay(),
       map_width(0), solid_north(false), solid_east(false),
       solid_south(false), solid_west(false), solid_checked(false)
 {
@@ -446,7 +446,7 @@ void map_lines::write_maplines(writer &outf) const
     const int h = height();
     marshallShort(outf, h);
     for (int i = 0; i < h; ++i)
-        marshallString(outf, lines[i]);
+        marshallString(outf, line(i));
 }
 
 void map_lines::read_maplines(reader &inf)
@@ -471,22 +471,29 @@ rectangle_iterator map_lines::get_iter() const
 
 char map_lines::operator () (const coord_def &c) const
 {
-    return lines[c.y][c.x];
+    return cells[cell(c.x, c.y)];
 }
 
 char& map_lines::operator () (const coord_def &c)
 {
-    return lines[c.y][c.x];
+    return (*this)(c.x, c.y);
 }
 
 char map_lines::operator () (int x, int y) const
 {
-    return lines[y][x];
+    return cells[cell(x, y)];
 }
 
 char& map_lines::operator () (int x, int y)
 {
-    return lines[y][x];
+    // The caller may write through the reference.
+    index.reset(nullptr);
+    return cells[cell(x, y)];
+}
+
+int map_lines::cell(int x, int y) const
+{
+    return y * map_width + x;
 }
 
 bool map_lines::in_bounds(const coord_def &c) const
@@ -496,7 +503,7 @@ bool map_lines::in_bounds(const coord_def &c) const
 
 bool map_lines::in_map(const coord_def &c) const
 {
-    return in_bounds(c) && lines[c.y][c.x] != ' ';
+    return in_bounds(c) && cells[cell(c.x, c.y)] != ' ';
 }
 
 map_lines &map_lines::operator = (const map_lines &map)
@@ -516,7 +523,9 @@ void map_lines::init_from(const map_lines &map)
     // Markers have to be regenerated, they will not be copied.
     clear_markers();
     overlay.reset(nullptr);
-    lines            = map.lines;
+    index.reset(nullptr);
+    cells            = map.cells;
+    map_height       = map.map_height;
     map_width        = map.map_width;
     solid_north      = map.solid_north;
     solid_east       = map.solid_east;
@@ -668,21 +677,190 @@ void map_lines::apply_overlays(const coord_def &c, bool is_layout)
     apply_grid_overlay(c, is_layout);
 }
 
-const vector<string> &map_lines::get_lines() const
+vector<string> map_lines::get_lines() const
 {
+    vector<string> lines;
+    lines.reserve(map_height);
+    for (int y = 0; y < map_height; ++y)
+        lines.push_back(line(y));
     return lines;
 }
 
-vector<string> &map_lines::get_lines()
+string map_lines::line(int y) const
 {
-    return lines;
+    auto row = cells.begin() + cell(0, y);
+    int len = map_width;
+    while (len > 0 && !row[len - 1])
+        --len;
+    return string(row, row + len);
 }
 
-void map_lines::add_line(const string &s)
+void map_lines::set_line(int y, const string &s)
 {
-    lines.push_back(s);
+    ASSERT(y >= 0);
+    if (y >= map_height)
+    {
+        cells.resize(cell(0, y + 1), 0);
+        map_height = y + 1;
+    }
     if (static_cast<int>(s.length()) > map_width)
-        map_width = s.length();
+        set_width(s.length());
+
+    auto row = cells.begin() + cell(0, y);
+    copy(s.begin(), s.end(), row);
+    fill(row + s.length(), row + map_width, 0);
+    index.reset(nullptr);
+}
+
+void map_lines::remove_line(int y)
+{
+    ASSERT_RANGE(y, 0, map_height);
+    cells.erase(cells.begin() + cell(0, y), cells.begin() + cell(0, y + 1));
+    --map_height;
+    index.reset(nullptr);
+}
+
+void map_lines::add_line(const string &s)
+{
+    set_line(map_height, s);
+}
+
+// Re-lay the cells out w to a row; the new cells are unfilled.
+void map_lines::set_width(int w)
+{
+    ASSERT(w >= map_width);
+    if (w == map_width)
+        return;
+
+    vector<char> wider(w * map_height, 0);
+    for (int y = 0; y < map_height; ++y)
+    {
+        copy(cells.begin() + cell(0, y), cells.begin() + cell(0, y + 1),
+             wider.begin() + y * w);
+    }
+    cells.swap(wider);
+    map_width = w;
+    index.reset(nullptr);
+}
+
+void map_lines::set_cell(int i, char c)
+{
+    const char old = cells[i];
+    if (old == c)
+        return;
+
+    cells[i] = c;
+    if (!index)
+        return;
+
+    const uint64_t bit = uint64_t(1) << (i & 63);
+    if (uint64_t *was = index->find(old))
+        was[i >> 6] &= ~bit;
+    index->insert(c)[i >> 6] |= bit;
+}
+
+map_lines::glyph_index::glyph_index(const vector<char> &cells)
+    : words(max<int>(1, (cells.size() + 63) / 64)), bits()
+{
+    fill(begin(slot), end(slot), -1);
+    for (int i = 0, size = cells.size(); i < size; ++i)
+        if (cells[i])
+            insert(cells[i])[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+const uint64_t *map_lines::glyph_index::find(int gly) const
+{
+    const int s = slot[static_cast<unsigned char>(gly)];
+    return s < 0 ? nullptr : &bits[s * words];
+}
+
+uint64_t *map_lines::glyph_index::find(int gly)
+{
+    const int s = slot[static_cast<unsigned char>(gly)];
+    return s < 0 ? nullptr : &bits[s * words];
+}
+
+uint64_t *map_lines::glyph_index::insert(int gly)
+{
+    int16_t &s = slot[static_cast<unsigned char>(gly)];
+    if (s < 0)
+    {
+        s = bits.size() / words;
+        bits.resize(bits.size() + words, 0);
+    }
+    return &bits[s * words];
+}
+
+const map_lines::glyph_index &map_lines::glyph_cells() const
+{
+    if (!index)
+        index.reset(new glyph_index(cells));
+    return *index;
+}
+
+// The cells holding any of the glyphs.
+void map_lines::glyph_mask(const string &glyphs, vector<uint64_t> &mask) const
+{
+    const glyph_index &gi = glyph_cells();
+    mask.assign(gi.words, 0);
+
+    bool seen[256] = { false };
+    for (const char gly : glyphs)
+    {
+        if (seen[static_cast<unsigned char>(gly)])
+            continue;
+        seen[static_cast<unsigned char>(gly)] = true;
+
+        if (const uint64_t *bits = gi.find(gly))
+            for (int w = 0; w < gi.words; ++w)
+                mask[w] |= bits[w];
+    }
+}
+
+static int _lowest_bit(uint64_t w)
+{
+    int b = 0;
+    for (int shift = 32; shift; shift >>= 1)
+        if (!(w & ((uint64_t(1) << shift) - 1)))
+        {
+            w >>= shift;
+            b += shift;
+        }
+    return b;
+}
+
+static int _highest_bit(uint64_t w)
+{
+    int b = 0;
+    for (int shift = 32; shift; shift >>= 1)
+        if (w >> shift)
+        {
+            w >>= shift;
+            b += shift;
+        }
+    return b;
+}
+
+// Call f with the index of each set bit in the mask, in ascending order.
+template <typename F>
+static void _for_each_cell(const vector<uint64_t> &mask, F f)
+{
+    for (int w = 0, words = mask.size(); w < words; ++w)
+        for (uint64_t bits = mask[w]; bits; bits &= bits - 1)
+            f(w * 64 + _lowest_bit(bits));
+}
+
+// As above, in descending order.
+template <typename F>
+static void _for_each_cell_reverse(const vector<uint64_t> &mask, F f)
+{
+    for (int w = mask.size() - 1; w >= 0; --w)
+        for (uint64_t bits = mask[w]; bits;)
+        {
+            const int b = _highest_bit(bits);
+            bits &= ~(uint64_t(1) << b);
+            f(w * 64 + b);
+        }
 }
 
 string map_lines::clean_shuffle(string s)
@@ -1018,7 +1196,7 @@ int map_lines::width() const
 
 int map_lines::height() const
 {
-    return lines.size();
+    return map_height;
 }
 
 void map_lines::extend(int min_width, int min_height, char fill)
@@ -1030,18 +1208,17 @@ void map_lines::extend(int min_width, int min_height, char fill)
     int old_width = width();
     int old_height = height();
 
-    if (static_cast<int>(lines.size()) < min_height)
+    if (height() < min_height)
     {
         dirty = true;
-        while (static_cast<int>(lines.size()) < min_height)
+        while (height() < min_height)
             add_line(string(min_width, fill));
     }
 
     if (width() < min_width)
     {
         dirty = true;
-        lines[0] += string(min_width - width(), fill);
-        map_width = max(map_width, min_width);
+        set_width(min_width);
     }
 
     if (!dirty)
@@ -1069,7 +1246,7 @@ coord_def map_lines::size() const
 
 int map_lines::glyph(int x, int y) const
 {
-    return lines[y][x];
+    return cells[cell(x, y)];
 }
 
 int map_lines::glyph(const coord_def &c) const
@@ -1131,10 +1308,12 @@ bool map_lines::solid_borders(map_section_type border)
 void map_lines::clear()
 {
     clear_markers();
-    lines.clear();
+    cells.clear();
+    index.reset(nullptr);
     keyspecs.clear();
     overlay.reset(nullptr);
     map_width = 0;
+    map_height = 0;
     solid_checked = false;
 
     // First non-legal character.
@@ -1151,8 +1330,9 @@ void map_lines::subst(string &s, subst_spec &spec)
 void map_lines::subst(subst_spec &spec)
 {
     ASSERT(!spec.key.empty());
-    for (string &line : lines)
-        subst(line, spec);
+    vector<uint64_t> mask;
+    glyph_mask(spec.key, mask);
+    _for_each_cell(mask, [&](int i) { set_cell(i, spec.value()); });
 }
 
 void map_lines::bind_overlay()
@@ -1412,34 +1592,33 @@ void map_lines::overlay_tiles(tile_spec &spec)
     if (!overlay.get())
         overlay.reset(new overlay_matrix(width(), height()));
 
-    for (int y = 0, ysize = lines.size(); y < ysize; ++y)
+    vector<uint64_t> mask;
+    glyph_mask(spec.key, mask);
+    _for_each_cell(mask, [&](int i)
     {
-        string::size_type pos = 0;
-        while ((pos = lines[y].find_first_of(spec.key, pos)) != string::npos)
-        {
-            if (spec.floor)
-                (*overlay)(pos, y).floortile = spec.get_tile();
-            else if (spec.feat)
-                (*overlay)(pos, y).tile      = spec.get_tile();
-            else
-                (*overlay)(pos, y).rocktile  = spec.get_tile();
+        overlay_def &od = (*overlay)(i % map_width, i / map_width);
+        if (spec.floor)
+            od.floortile = spec.get_tile();
+        else if (spec.feat)
+            od.tile      = spec.get_tile();
+        else
+            od.rocktile  = spec.get_tile();
 
-            (*overlay)(pos, y).no_random = spec.no_random;
-            (*overlay)(pos, y).last_tile = spec.last_tile;
-            ++pos;
-        }
-    }
+        od.no_random = spec.no_random;
+        od.last_tile = spec.last_tile;
+    });
 }
 
 void map_lines::nsubst(nsubst_spec &spec)
 {
+    vector<uint64_t> mask;
+    glyph_mask(spec.key, mask);
+
     vector<coord_def> positions;
-    for (int y = 0, ysize = lines.size(); y < ysize; ++y)
+    _for_each_cell(mask, [&](int i)
     {
-        string::size_type pos = 0;
-        while ((pos = lines[y].find_first_of(spec.key, pos)) != string::npos)
-            positions.emplace_back(pos++, y);
-    }
+        positions.emplace_back(i % map_width, i / map_width);
+    });
     shuffle_array(positions);
 
     int pcount = 0;
@@ -1463,7 +1642,7 @@ int map_lines::apply_nsubst(vector<coord_def> &pos, int start, int nsub,
     {
         const int val = spec.value();
         const coord_def &c = pos[i];
-        lines[c.y][c.x] = val;
+        set_cell(cell(c.x, c.y), val);
         ++substituted;
     }
     return substituted;
@@ -1502,42 +1681,45 @@ void map_lines::resolve_shuffle(const string &shufflage)
     if (toshuffle.empty() || shuffled.empty())
         return;
 
-    for (string &s : lines)
-    {
-        for (char &c : s)
-        {
-            string::size_type pos = toshuffle.find(c);
-            if (pos != string::npos)
-                c = shuffled[pos];
-        }
-    }
+    // Each glyph maps to the shuffled glyph at its first occurrence.
+    char xlat[256];
+    for (int i = 0; i < 256; ++i)
+        xlat[i] = i;
+    for (int i = toshuffle.length() - 1; i >= 0; --i)
+        xlat[static_cast<unsigned char>(toshuffle[i])] = shuffled[i];
+
+    for (char &c : cells)
+        if (c)
+            c = xlat[static_cast<unsigned char>(c)];
+    index.reset(nullptr);
 }
 
 void map_lines::clear(const string &clearchars)
 {
-    for (string &s : lines)
-    {
-        for (char &c : s)
-        {
-            string::size_type pos = clearchars.find(c);
-            if (pos != string::npos)
-                c = ' ';
-        }
-    }
+    vector<uint64_t> mask;
+    glyph_mask(clearchars, mask);
+    _for_each_cell(mask, [&](int i) { set_cell(i, ' '); });
 }
 
 void map_lines::normalise(char fillch)
 {
-    for (string &s : lines)
-        if (static_cast<int>(s.length()) < map_width)
-            s += string(map_width - s.length(), fillch);
+    bool filled = false;
+    for (char &c : cells)
+        if (!c)
+        {
+            c = fillch;
+            filled = true;
+        }
+    if (filled)
+        index.reset(nullptr);
 }
 
 // Should never be attempted if the map has a defined orientation, or if one
 // of the dimensions is greater than the lesser of GXM,GYM.
 void map_lines::rotate(bool clockwise)
 {
-    vector<string> newlines;
+    vector<char> newcells;
+    newcells.reserve(cells.size());
 
     // normalise() first for convenience.
     normalise();
@@ -1546,31 +1728,26 @@ void map_lines::rotate(bool clockwise)
               xe = clockwise? map_width : -1,
               xi = clockwise? 1 : -1;
 
-    const int ys = clockwise? (int) lines.size() - 1 : 0,
-              ye = clockwise? -1 : (int) lines.size(),
+    const int ys = clockwise? map_height - 1 : 0,
+              ye = clockwise? -1 : map_height,
               yi = clockwise? -1 : 1;
 
     for (int i = xs; i != xe; i += xi)
-    {
-        string line;
-
         for (int j = ys; j != ye; j += yi)
-            line += lines[j][i];
-
-        newlines.push_back(line);
-    }
+            newcells.push_back(cells[cell(i, j)]);
 
     if (overlay.get())
     {
-        auto new_overlay = make_unique<overlay_matrix>(lines.size(), map_width);
+        auto new_overlay = make_unique<overlay_matrix>(map_height, map_width);
         for (int i = xs, y = 0; i != xe; i += xi, ++y)
             for (int j = ys, x = 0; j != ye; j += yi, ++x)
                 (*new_overlay)(x, y) = (*overlay)(i, j);
         overlay = move(new_overlay);
     }
 
-    map_width = lines.size();
-    lines     = newlines;
+    swap(map_width, map_height);
+    cells.swap(newcells);
+    index.reset(nullptr);
     rotate_markers(clockwise);
     solid_checked = false;
 }
@@ -1619,15 +1796,15 @@ void map_lines::rotate_markers(bool clock)
 
 void map_lines::vmirror()
 {
-    const int vsize = lines.size();
+    const int vsize = map_height;
     const int midpoint = vsize / 2;
 
     for (int i = 0; i < midpoint; ++i)
     {
-        string temp = lines[i];
-        lines[i] = lines[vsize - 1 - i];
-        lines[vsize - 1 - i] = temp;
+        swap_ranges(cells.begin() + cell(0, i), cells.begin() + cell(0, i + 1),
+                    cells.begin() + cell(0, vsize - 1 - i));
     }
+    index.reset(nullptr);
 
     if (overlay.get())
     {
@@ -1643,13 +1820,13 @@ void map_lines::vmirror()
 void map_lines::hmirror()
 {
     const int midpoint = map_width / 2;
-    for (string &s : lines)
-        for (int j = 0; j < midpoint; ++j)
-            swap(s[j], s[map_width - 1 - j]);
+    for (int i = 0; i < map_height; ++i)
+        reverse(cells.begin() + cell(0, i), cells.begin() + cell(0, i + 1));
+    index.reset(nullptr);
 
     if (overlay.get())
     {
-        for (int i = 0, vsize = lines.size(); i < vsize; ++i)
+        for (int i = 0, vsize = map_height; i < vsize; ++i)
             for (int j = 0; j < midpoint; ++j)
                 swap((*overlay)(j, i), (*overlay)(map_width - 1 - j, i));
     }
@@ -1767,78 +1944,43 @@ string map_lines::add_key_mask(const string &s)
 
 vector<coord_def> map_lines::find_glyph(int gly) const
 {
-    vector<coord_def> points;
-    for (int y = height() - 1; y >= 0; --y)
-    {
-        for (int x = width() - 1; x >= 0; --x)
-        {
-            const coord_def c(x, y);
-            if ((*this)(c) == gly)
-                points.push_back(c);
-        }
-    }
-    return points;
+    return find_glyph(string(1, gly));
 }
 
 vector<coord_def> map_lines::find_glyph(const string &glyphs) const
 {
     vector<coord_def> points;
-    for (int y = height() - 1; y >= 0; --y)
+    vector<uint64_t> mask;
+    glyph_mask(glyphs, mask);
+    _for_each_cell_reverse(mask, [&](int i)
     {
-        for (int x = width() - 1; x >= 0; --x)
-        {
-            const coord_def c(x, y);
-            if (glyphs.find((*this)(c)) != string::npos)
-                points.push_back(c);
-        }
-    }
+        points.emplace_back(i % map_width, i / map_width);
+    });
     return points;
 }
 
 coord_def map_lines::find_first_glyph(int gly) const
 {
-    for (int y = 0, h = height(); y < h; ++y)
-    {
-        string::size_type pos = lines[y].find(gly);
-        if (pos != string::npos)
-            return coord_def(pos, y);
-    }
-
-    return coord_def(-1, -1);
+    return find_first_glyph(string(1, gly));
 }
 
 coord_def map_lines::find_first_glyph(const string &glyphs) const
 {
-    for (int y = 0, h = height(); y < h; ++y)
-    {
-        string::size_type pos = lines[y].find_first_of(glyphs);
-        if (pos != string::npos)
-            return coord_def(pos, y);
-    }
+    vector<uint64_t> mask;
+    glyph_mask(glyphs, mask);
+    for (int w = 0, words = mask.size(); w < words; ++w)
+        if (mask[w])
+        {
+            const int i = w * 64 + _lowest_bit(mask[w]);
+            return coord_def(i % map_width, i / map_width);
+        }
     return coord_def(-1, -1);
 }
 
 bool map_lines::find_bounds(int gly, coord_def &tl, coord_def &br) const
 {
-    tl = coord_def(width(), height());
-    br = coord_def(-1, -1);
-
-    if (width() == 0 || height() == 0)
-        return false;
-
-    for (rectangle_iterator ri(get_iter()); ri; ++ri)
-    {
-        const coord_def mc = *ri;
-        if ((*this)(mc) != gly)
-            continue;
-
-        tl.x = min(tl.x, mc.x);
-        tl.y = min(tl.y, mc.y);
-        br.x = max(br.x, mc.x);
-        br.y = max(br.y, mc.y);
-    }
-
-    return br.x >= 0;
+    const char str[] = { static_cast<char>(gly), 0 };
+    return find_bounds(str, tl, br);
 }
 
 bool map_lines::find_bounds(const char *str, coord_def &tl, coord_def &br) const
@@ -1849,23 +1991,16 @@ bool map_lines::find_bounds(const char *str, coord_def &tl, coord_def &br) const
     if (width() == 0 || height() == 0)
         return false;
 
-    for (rectangle_iterator ri(get_iter()); ri; ++ri)
+    vector<uint64_t> mask;
+    glyph_mask(str, mask);
+    _for_each_cell(mask, [&](int i)
     {
-        ASSERT(ri);
-        const coord_def &mc = *ri;
-        const size_t len = strlen(str);
-        for (size_t i = 0; i < len; ++i)
-        {
-            if ((*this)(mc) == str[i])
-            {
-                tl.x = min(tl.x, mc.x);
-                tl.y = min(tl.y, mc.y);
-                br.x = max(br.x, mc.x);
-                br.y = max(br.y, mc.y);
-                break;
-            }
-        }
-    }
+        const coord_def mc(i % map_width, i / map_width);
+        tl.x = min(tl.x, mc.x);
+        tl.y = min(tl.y, mc.y);
+        br.x = max(br.x, mc.x);
+        br.y = max(br.y, mc.y);
+    });
 
     return br.x >= 0;
 }
@@ -1874,8 +2009,8 @@ bool map_lines::fill_zone(travel_distance_grid_t &tpd, const coord_def &start,
                           const coord_def &tl, const coord_def &br, int zone,
                           const char *wanted, const char *passable) const
 {
-    // This is the map_lines equivalent of _dgn_fill_zone.
-    // It's unfortunately extremely similar, but not close enough to combine.
+    // A flood fill of a single zone; the dungeon builder labels every
+    // zone at once with _dgn_label_zones instead.
 
     bool ret = false;
     list<coord_def> points[2];
@@ -2015,22 +2150,14 @@ map_lines::iterator::iterator(map_lines &_maplines, const string &_key)
 
 void map_lines::iterator::advance()
 {
-    const int height = maplines.height();
-    while (p.y < height)
-    {
-        string::size_type place = p.x;
-        if (place < maplines.lines[p.y].length())
+    const int width = maplines.width(), height = maplines.height();
+    for (; p.y < height; ++p.y, p.x = 0)
+        for (; p.x < width; ++p.x)
         {
-            place = maplines.lines[p.y].find_first_of(key, place);
-            if (place != string::npos)
-            {
-                p.x = place;
-                break;
-            }
+            const char c = maplines.cells[maplines.cell(p.x, p.y)];
+            if (c && key.find(c) != string::npos)
+                return;
         }
-        ++p.y;
-        p.x = 0;
-    }
 }
 
 map_lines::iterator::operator bool() const
@@ -2421,9 +2548,24 @@ void map_def::load()
     inf.advance(cache_offset);
     read_full(inf, true);
 
+    // Every placement copies the map, so compile here once rather than in
+    // each copy.
+    compile_lua();
+
     index_only = false;
 }
 
+// Compiles the map's Lua chunks to bytecode. A chunk that doesn't compile
+// is left as source, so that its error is reported when it's run.
+void map_def::compile_lua()
+{
+    for (dlua_chunk *chunk : { &prelude, &mapchunk, &main,
+                               &validate, &veto, &epilogue })
+    {
+        chunk->compile(dlua);
+    }
+}
+
 vector<coord_def> map_def::find_glyph(int glyph) const
 {
     return map.find_glyph(glyph);
@@ -404,8 +404,12 @@ public:
     void apply_grid_overlay(const coord_def &pos, bool is_layout);
     void apply_overlays(const coord_def &pos, bool is_layout);
 
-    const vector<string> &get_lines() const;
-    vector<string> &get_lines();
+    // The map as one string per line; unfilled cells of short lines are
+    // trimmed, so this round-trips what add_line() was given.
+    vector<string> get_lines() const;
+    string line(int y) const;
+    void set_line(int y, const string &s);
+    void remove_line(int y);
 
     rectangle_iterator get_iter() const;
     char operator () (const coord_def &c) const;
@@ -441,6 +445,10 @@ public:
                                 const Matrix<bool> &mask, const map_def &vault);
 private:
     void init_from(const map_lines &map);
+    int cell(int x, int y) const;
+    void set_width(int w);
+    void set_cell(int i, char c);
+    void glyph_mask(const string &glyphs, vector<uint64_t> &mask) const;
     void vmirror_markers();
     void hmirror_markers();
     void rotate_markers(bool clock);
@@ -497,7 +505,31 @@ private:
 
 private:
     vector<map_marker *> markers;
-    vector<string> lines;
+
+    // The glyphs, row by row, map_width cells to a row. Cells beyond the
+    // end of a line shorter than the map hold 0 until normalise() fills
+    // them.
+    vector<char> cells;
+    int map_height;
+
+    // For each glyph in the map, a bitmask of the cells holding it, so that
+    // substitutions and searches visit only the cells they affect. Built on
+    // first use; set_cell() keeps it current, and anything else that writes
+    // cells throws it away.
+    struct glyph_index
+    {
+        explicit glyph_index(const vector<char> &cells);
+
+        const uint64_t *find(int gly) const;
+        uint64_t *find(int gly);
+        uint64_t *insert(int gly);
+
+        int words;
+        int16_t slot[256];
+        vector<uint64_t> bits;
+    };
+    mutable unique_ptr<glyph_index> index;
+    const glyph_index &glyph_cells() const;
 
     struct overlay_def
     {
@@ -1187,6 +1219,7 @@ public:
 
     void load();
     void strip();
+    void compile_lua();
 
     int weight(const level_id &lid) const;
     map_chance chance(const level_id &lid) const;
@@ -417,13 +417,12 @@ static bool _map_safe_vault_place(const map_def &map,
     const bool vault_can_replace_portals =
         map.has_tag("replace_portal");
 
-    const vector<string> &lines = map.map.get_lines();
     for (rectangle_iterator ri(c, c + size - 1); ri; ++ri)
     {
         const coord_def cp(*ri);
         const coord_def dp(cp - c);
 
-        if (lines[dp.y][dp.x] == ' ')
+        if (map.map.glyph(dp) == ' ')
             continue;
 
         // Unconditionally allow portal placements to work.
@@ -480,13 +479,13 @@ static bool _connected_minivault_place(const coord_def &c,
         return true;
 
     // Must not be completely isolated.
-    const vector<string> &lines = place.map.map.get_lines();
+    const map_lines &lines = place.map.map;
 
     for (rectangle_iterator ri(c, c + place.size - 1); ri; ++ri)
     {
         const coord_def &ci(*ri);
 
-        if (lines[ci.y - c.y][ci.x - c.x] == ' ')
+        if (lines(ci - c) == ' ')
             continue;
 
         if (_may_overwrite_feature(ci, false, false)
@@ -1369,7 +1368,10 @@ static void _write_map_full(const string &filebase, size_t vs, size_t ve,
     marshallByte(outf, WORD_LEN);
     marshallSigned(outf, mtime);
     for (size_t i = vs; i < ve; ++i)
+    {
+        vdefs[i].compile_lua();
         vdefs[i].write_full(outf);
+    }
     fclose(fp);
 }
 
@@ -1901,15 +1901,42 @@ void Menu::webtiles_update_section_boundaries()
 // Menu colouring
 //
 
-int menu_colour(const string &text, const string &prefix, const string &tag)
+// Menus redraw the same few dozen entries over and over, so menu_colour()
+// remembers its answers. Entries are keyed on the tag and the full text,
+// which for items includes everything identification can change, and are
+// all dropped when the options change.
+static map<string, int> _menu_colour_cache;
+static text_pattern_union _menu_colour_patterns;
+static bool _menu_colour_loose = false;   // Some pattern isn't in the union.
+static unsigned int _menu_colour_generation = 0;
+
+static const size_t MENU_COLOUR_CACHE_SIZE = 2048;
+
+static void _update_menu_colour_cache()
 {
-    const string tmp_text = prefix + text;
+    if (_menu_colour_generation == Options.generation)
+        return;
+
+    _menu_colour_cache.clear();
+    _menu_colour_patterns.clear();
+    _menu_colour_loose = false;
+    for (const colour_mapping &cm : Options.menu_colour_mappings)
+        if (!_menu_colour_patterns.add(cm.pattern))
+            _menu_colour_loose = true;
+
+    _menu_colour_generation = Options.generation;
+}
+
+static int _find_menu_colour(const string &text, const string &tag)
+{
+    if (!_menu_colour_loose && !_menu_colour_patterns.matches(text))
+        return -1;
 
     for (const colour_mapping &cm : Options.menu_colour_mappings)
     {
         if ((cm.tag.empty() || cm.tag == "any" || cm.tag == tag
                || cm.tag == "inventory" && tag == "pickup")
-            && cm.pattern.matches(tmp_text))
+            && cm.pattern.matches(text))
         {
             return cm.colour;
         }
@@ -1917,6 +1944,23 @@ int menu_colour(const string &text, const string &prefix, const string &tag)
     return -1;
 }
 
+int menu_colour(const string &text, const string &prefix, const string &tag)
+{
+    _update_menu_colour_cache();
+
+    const string tmp_text = prefix + text;
+    const string key = tag + '\n' + tmp_text;
+
+    auto cached = _menu_colour_cache.find(key);
+    if (cached != _menu_colour_cache.end())
+        return cached->second;
+
+    if (_menu_colour_cache.size() >= MENU_COLOUR_CACHE_SIZE)
+        _menu_colour_cache.clear();
+
+    return _menu_colour_cache[key] = _find_menu_colour(tmp_text, tag);
+}
+
 int MenuHighlighter::entry_colour(const MenuEntry *entry) const
 {
     return entry->colour != MENU_ITEM_STOCK_COLOUR ? entry->colour
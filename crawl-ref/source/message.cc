@@ -1169,9 +1169,86 @@ void dprf(diag_type param, const char *format, ...)
 
 static bool _updating_view = false;
 
+// A cheap first test for one of the message option lists: one or two regex
+// matches over all of the list's patterns together, so that the list itself
+// need only be walked, in order, for messages some entry might match.
+struct message_prefilter
+{
+    text_pattern_union patterns;
+    // Channels with an entry the union can't hold, such as an empty
+    // pattern, which matches every message.
+    bool loose_all;
+    bool loose[NUM_MESSAGE_CHANNELS];
+
+    message_prefilter() { clear(); }
+
+    void clear()
+    {
+        patterns.clear();
+        loose_all = false;
+        memset(loose, 0, sizeof(loose));
+    }
+
+    void add(const text_pattern &pat, int channel = -1)
+    {
+        if (!pat.empty() && patterns.add(pat))
+            return;
+        if (channel >= 0 && channel < NUM_MESSAGE_CHANNELS)
+            loose[channel] = true;
+        else
+            loose_all = true;
+    }
+
+    bool may_match(msg_channel_type channel, const string &line) const
+    {
+        return loose_all || loose[channel] || patterns.matches(line);
+    }
+};
+
+static message_prefilter _more_filter, _flash_filter, _note_filter,
+                         _sound_filter, _colour_filter;
+// The Options.generation the filters were built for.
+static unsigned int _message_filters_generation = 0;
+
+static void _add_filters(message_prefilter &filter,
+                         const vector<message_filter> &option)
+{
+    filter.clear();
+    for (const message_filter &mf : option)
+        filter.add(mf.pattern, mf.channel);
+}
+
+static void _update_message_filters()
+{
+    if (_message_filters_generation == Options.generation)
+        return;
+
+    _add_filters(_more_filter, Options.force_more_message);
+    _add_filters(_flash_filter, Options.flash_screen_message);
+
+    _note_filter.clear();
+    for (const text_pattern &pat : Options.note_messages)
+        _note_filter.add(pat);
+
+    _sound_filter.clear();
+    for (const sound_mapping &sound : Options.sound_mappings)
+        _sound_filter.add(sound.pattern);
+
+    _colour_filter.clear();
+    for (const message_colour_mapping &mcm : Options.message_colour_mappings)
+        _colour_filter.add(mcm.message.pattern, mcm.message.channel);
+
+    _message_filters_generation = Options.generation;
+}
+
 static bool _check_option(const string& line, msg_channel_type channel,
-                          const vector<message_filter>& option)
+                          const vector<message_filter>& option,
+                          const message_prefilter &filter)
 {
+    _update_message_filters();
+    if (!filter.may_match(channel, line))
+        return false;
+
     return any_of(begin(option),
                   end(option),
                   bind(mem_fn(&message_filter::is_filtered),
@@ -1180,12 +1257,14 @@ static bool _check_option(const string& line, msg_channel_type channel,
 
 static bool _check_more(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.force_more_message);
+    return _check_option(line, channel, Options.force_more_message,
+                         _more_filter);
 }
 
 static bool _check_flash_screen(const string& line, msg_channel_type channel)
 {
-    return _check_option(line, channel, Options.flash_screen_message);
+    return _check_option(line, channel, Options.flash_screen_message,
+                         _flash_filter);
 }
 
 static bool _check_join(const string& line, msg_channel_type channel)
@@ -1466,20 +1545,21 @@ static void mpr_check_patterns(const string& message,
                                msg_channel_type channel,
                                int param)
 {
-    for (const text_pattern &pat : Options.note_messages)
-    {
-        if (channel == MSGCH_EQUIPMENT || channel == MSGCH_FLOOR_ITEMS
-            || channel == MSGCH_MULTITURN_ACTION
-            || channel == MSGCH_EXAMINE || channel == MSGCH_EXAMINE_FILTER
-            || channel == MSGCH_TUTORIAL || channel == MSGCH_DGL_MESSAGE)
-        {
-            continue;
-        }
+    _update_message_filters();
 
-        if (pat.matches(message))
+    if (channel != MSGCH_EQUIPMENT && channel != MSGCH_FLOOR_ITEMS
+        && channel != MSGCH_MULTITURN_ACTION
+        && channel != MSGCH_EXAMINE && channel != MSGCH_EXAMINE_FILTER
+        && channel != MSGCH_TUTORIAL && channel != MSGCH_DGL_MESSAGE
+        && _note_filter.may_match(channel, message))
+    {
+        for (const text_pattern &pat : Options.note_messages)
         {
-            take_note(Note(NOTE_MESSAGE, channel, param, message));
-            break;
+            if (pat.matches(message))
+            {
+                take_note(Note(NOTE_MESSAGE, channel, param, message));
+                break;
+            }
         }
     }
 
@@ -1487,6 +1567,9 @@ static void mpr_check_patterns(const string& message,
         interrupt_activity(AI_MESSAGE, channel_to_str(channel) + ":" + message);
 
 #ifdef USE_SOUND
+    if (!_sound_filter.may_match(channel, message))
+        return;
+
     for (const sound_mapping &sound : Options.sound_mappings)
     {
         // Maybe we should allow message channel matching as for
@@ -1533,6 +1616,10 @@ static msg_colour_type prepare_message(const string& imsg,
     if (colour != MSGCOL_MUTED)
         mpr_check_patterns(imsg, channel, param);
 
+    _update_message_filters();
+    if (!_colour_filter.may_match(channel, imsg))
+        return colour;
+
     for (const message_colour_mapping &mcm : Options.message_colour_mappings)
     {
         if (mcm.message.is_filtered(channel, imsg))
@@ -122,6 +122,7 @@ void get_recent_messages(vector<string> &messages,
                          vector<msg_channel_type> &channels);
 
 int channel_to_colour(msg_channel_type channel, int param = 0);
+
 bool strip_channel_prefix(string &text, msg_channel_type &channel,
                           bool silence = false);
 
@@ -16,6 +16,7 @@
 #include "cloud.h"
 #include "colour.h"
 #include "coordit.h"
+#include "dbg-prof.h"
 #include "dbg-scan.h"
 #include "delay.h"
 #include "directn.h" // feature_description_at
@@ -1235,6 +1236,7 @@ static void _pre_monster_move(monster& mons)
 void handle_monster_move(monster* mons)
 {
     ASSERT(mons); // XXX: change to monster &mons
+    PROF_SCOPE_NAMED("monster: " + mons_type_name(mons->type, DESC_PLAIN));
     const monsterentry* entry = get_monster_data(mons->type);
     if (!entry)
         return;
@@ -2040,6 +2042,7 @@ static void _display_just_seen()
  */
 void handle_monsters(bool with_noise)
 {
+    PROF_SCOPE("handle_monsters");
     for (monster_iterator mi; mi; ++mi)
     {
         _pre_monster_move(**mi);
@@ -20,6 +20,7 @@
 #include "colour.h"
 #include "coordit.h"
 #include "database.h"
+#include "dbg-prof.h"
 #include "delay.h"
 #include "directn.h"
 #include "english.h"
@@ -3920,6 +3921,10 @@ static mon_spell_slot _choose_spell_to_cast(monster &mons,
                                             const monster_spells &hspell_pass,
                                             bool ignore_good_idea)
 {
+    // Nothing moves while we weigh up the spells, so a spell considered more
+    // than once need only be traced once.
+    tracer_cache_scope tracers;
+
     // Monsters caught in a net try to get away.
     // This is only urgent if enemies are around.
     if (mon_enemies_around(&mons) && mons.caught() && one_chance_in(15))
@@ -4025,7 +4030,6 @@ bool handle_mon_spell(monster* mons)
     // If no useful spells... cast no spell.
     if (!hspell_pass.size())
         return false;
-
     bolt beem = setup_targetting_beam(*mons);
 
     bool ignore_good_idea = false;
@@ -5612,6 +5616,7 @@ static void _mons_upheaval(monster& mons, actor& foe)
 void mons_cast(monster* mons, bolt pbolt, spell_type spell_cast,
                mon_spell_slot_flags slot_flags, bool do_noise)
 {
+    PROF_SCOPE_NAMED(string("spell: ") + spell_title(spell_cast));
     // check sputtercast state for e.g. floating eyes. assumption: all
     // sputtercasting monsters have one charge status and use it for all of
     // their spells.
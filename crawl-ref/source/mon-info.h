@@ -260,6 +260,11 @@ struct monster_info : public monster_info_base
         return *this;
     }
 
+    // A snapshot that is about to be stored can hand over its strings,
+    // props and items rather than having them copied.
+    monster_info(monster_info&& mi) = default;
+    monster_info& operator=(monster_info&& mi) = default;
+
     void to_string(int count, string& desc, int& desc_colour,
                    bool fullname = true, const char *adjective = nullptr) const;
 
@@ -274,6 +274,8 @@ public:
 
     // internal use only:
     int         sc_entries;      // # of score entries
+    unsigned int generation;     // Bumped whenever any option may have
+                                 // changed, for caches of derived data
     int         sc_format;       // Format for score entries
 
     vector<pair<int, int> > hp_colour;
@@ -1649,6 +1649,7 @@ void redraw_screen(bool show_updates)
 #endif
 
     draw_border();
+    invalidate_view_cells();
 
     you.redraw_title        = true;
     you.redraw_hit_points   = true;
@@ -14,6 +14,8 @@
 #endif
 
 #include "pattern.h"
+
+#include "libutil.h"
 #include "stringutil.h"
 
 #if defined(REGEX_PCRE)
@@ -227,3 +229,81 @@ pattern_match plaintext_pattern::match_location(const string &s) const
     else
         return pattern_match::failed(s);
 }
+
+// Whether a pattern still means the same thing when wrapped in a group and
+// alternated with others: backreferences, recursion and numbered groups
+// depend on where the pattern sits, and backtracking verbs act on the whole
+// match. Anything doubtful is left out of the union.
+static bool _pattern_is_self_contained(const string &pat)
+{
+    for (size_t i = 0; i + 1 < pat.length(); ++i)
+    {
+        if (pat[i] == '\\')
+        {
+            if (pat[i + 1] >= '1' && pat[i + 1] <= '9'
+                || strchr("gkK", pat[i + 1]))
+            {
+                return false;
+            }
+            ++i;
+        }
+        else if (pat[i] == '(')
+        {
+            if (pat[i + 1] == '*')
+                return false;
+            if (pat[i + 1] == '?' && i + 2 < pat.length()
+                && (isadigit(pat[i + 2]) || strchr("R&+-P|", pat[i + 2])))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool text_pattern_union::add(const text_pattern &tp)
+{
+    if (tp.empty() || !tp.valid() || !_pattern_is_self_contained(tp.tostring()))
+        return false;
+
+    const bool icase = tp.case_insensitive();
+    string &alts = alternatives[icase];
+    if (!alts.empty())
+        alts += "|";
+#ifdef REGEX_PCRE
+    alts += "(?:" + tp.tostring() + ")";
+#else
+    alts += "(" + tp.tostring() + ")";
+#endif
+    // Compiled lazily on the first match.
+    combined[icase] = text_pattern(alts, icase);
+    return true;
+}
+
+void text_pattern_union::clear()
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        alternatives[i].clear();
+        combined[i] = text_pattern();
+    }
+}
+
+bool text_pattern_union::empty() const
+{
+    return alternatives[0].empty() && alternatives[1].empty();
+}
+
+bool text_pattern_union::matches(const string &s) const
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        if (alternatives[i].empty())
+            continue;
+        // If the alternation is too big for the library, err on the side of
+        // letting the caller check the patterns one by one.
+        if (!combined[i].valid() || combined[i].matches(s))
+            return true;
+    }
+    return false;
+}
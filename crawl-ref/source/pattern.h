@@ -117,6 +117,8 @@ public:
         return pattern;
     }
 
+    bool case_insensitive() const { return ignore_case; }
+
 private:
     string pattern;
     mutable void *compiled_pattern;
@@ -155,4 +157,23 @@ private:
     string pattern;
     bool ignore_case;
 };
+
+// Many text_patterns folded into one alternation per case mode, so a string
+// can be tested against all of them with one or two regex matches instead
+// of one per pattern. The regex libraries don't say which alternative
+// matched, so this is a prefilter: matches() is true if any added pattern
+// might match.
+class text_pattern_union
+{
+public:
+    bool add(const text_pattern &tp);
+    void clear();
+    bool empty() const;
+    bool matches(const string &s) const;
+
+private:
+    // Indexed by ignore_case.
+    string alternatives[2];
+    text_pattern combined[2];
+};
 #endif
@@ -41,6 +41,7 @@
 #include "hints.h"
 #include "hiscores.h"
 #include "invent.h"
+#include "itemname.h"
 #include "itemprop.h"
 #include "items.h"
 #include "item_use.h"
@@ -5026,6 +5027,7 @@ player::player()
     dactions.clear();
     level_stack.clear();
     type_ids.init(false);
+    invalidate_item_names();
 
     banished_by.clear();
     banished_power = 0;
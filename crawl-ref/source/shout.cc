@@ -15,6 +15,7 @@
 #include "art-enum.h"
 #include "branch.h"
 #include "database.h"
+#include "dbg-prof.h"
 #include "directn.h"
 #include "english.h"
 #include "env.h"
@@ -763,6 +764,7 @@ void yell(const actor* mon)
 
 void apply_noises()
 {
+    PROF_SCOPE("apply_noises");
     // [ds] This copying isn't awesome, but we cannot otherwise handle
     // the case where one set of noises wakes up monsters who then let
     // out yips of their own, modifying _noise_grid while it is in the
@@ -416,6 +416,27 @@ string Stash::stash_item_name(const item_def &item)
     return name;
 }
 
+// Find or rebuild the search text for the i'th item of a stash or shop,
+// given its current name.
+static stash_search_text &_search_text(vector<stash_search_text> &cache,
+                                       size_t i, const item_def &item,
+                                       const string &name, bool exclusive)
+{
+    if (cache.size() <= i)
+        cache.resize(i + 1);
+
+    stash_search_text &text = cache[i];
+    if (text.name != name)
+    {
+        text.name = name;
+        text.annotation = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE,
+                                              &item, exclusive);
+        text.description.clear();
+        text.described = false;
+    }
+    return text;
+}
+
 string Stash::description() const
 {
     if (items.empty())
@@ -448,12 +469,20 @@ vector<stash_search_result> Stash::matches_search(
     if (empty())
         return results;
 
-    for (const item_def &item : items)
+    search_cache.resize(items.size());
+    for (size_t i = 0; i < items.size(); ++i)
     {
-        const string s   = stash_item_name(item);
-        const string ann = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE, &item);
-        if (search.matches(prefix + " " + ann + " " + s)
-            || is_dumpable_artefact(item) && search.matches(chardump_desc(item)))
+        const item_def &item = items[i];
+        const string s = stash_item_name(item);
+        stash_search_text &text = _search_text(search_cache, i, item, s,
+                                               false);
+        if (!text.described && is_dumpable_artefact(item))
+            text.description = chardump_desc(item);
+        text.described = true;
+
+        if (search.matches(prefix + " " + text.annotation + " " + s)
+            || is_dumpable_artefact(item)
+               && search.matches(text.description))
         {
             stash_search_result res;
             res.match = s;
@@ -711,14 +740,19 @@ vector<stash_search_result> ShopInfo::matches_search(
             return results;
     }
 
-    for (const item_def &item : shop.stock)
+    search_cache.resize(shop.stock.size());
+    for (size_t i = 0; i < shop.stock.size(); ++i)
     {
+        const item_def &item = shop.stock[i];
         const string sname = shop_item_name(item);
-        const string ann   = stash_annotate_item(STASH_LUA_SEARCH_ANNOTATE,
-                                                 &item, true);
-
-        if (search.matches(prefix + " " + ann + " " + sname)
-            || search.matches(shop_item_desc(item)))
+        stash_search_text &text = _search_text(search_cache, i, item, sname,
+                                               true);
+        if (!text.described)
+            text.description = shop_item_desc(item);
+        text.described = true;
+
+        if (search.matches(prefix + " " + text.annotation + " " + sname)
+            || search.matches(text.description))
         {
             stash_search_result res;
             res.match = sname;
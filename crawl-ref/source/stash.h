@@ -18,6 +18,20 @@ class writer;
 class StashMenu;
 
 struct stash_search_result;
+
+// What a stash search matches an item against besides its place: the Lua and
+// spell annotations and, for artefacts, the full description. These cost far
+// more to build than the regex matches do, so they are remembered until the
+// item's name changes, which it does on identification and rotting as well
+// as whenever the item itself changes.
+struct stash_search_text
+{
+    string name;
+    string annotation;
+    string description;
+    bool   described = false;
+};
+
 class Stash
 {
 public:
@@ -77,6 +91,9 @@ private:
 
     vector<item_def> items;
 
+    // Parallel to items; filled in by searches.
+    mutable vector<stash_search_text> search_cache;
+
     static bool are_items_same(const item_def &, const item_def &,
                                bool exact = false);
 
@@ -107,6 +124,9 @@ private:
     string shop_item_name(const item_def &it) const;
     string shop_item_desc(const item_def &it) const;
 
+    // Parallel to shop.stock; filled in by searches.
+    mutable vector<stash_search_text> search_cache;
+
     friend class ST_ItemIterator;
 };
 
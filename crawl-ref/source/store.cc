@@ -1240,6 +1240,28 @@ static map<string, int> accesses;
 //////////////////
 // Misc functions
 
+// Strings for the keys most recently looked up by pointer, so that the
+// literal keys used all over the code needn't be copied into a new string
+// on every lookup. A pointer may since have been reused for other text, so
+// an entry is only used if its contents still match.
+static const string &_key_string(const char *key)
+{
+    struct key_entry
+    {
+        const char *ptr = nullptr;
+        string str;
+    };
+    static key_entry cache[256];
+
+    key_entry &entry = cache[(reinterpret_cast<uintptr_t>(key) >> 2) & 255];
+    if (entry.ptr != key || entry.str != key)
+    {
+        entry.ptr = key;
+        entry.str = key;
+    }
+    return entry.str;
+}
+
 bool CrawlHashTable::exists(const string &key) const
 {
     ACCESS(key);
@@ -1247,6 +1269,16 @@ bool CrawlHashTable::exists(const string &key) const
     return find(key) != end();
 }
 
+bool CrawlHashTable::exists(const char *key) const
+{
+    return !empty() && exists(_key_string(key));
+}
+
+CrawlHashTable::size_type CrawlHashTable::erase(const char *key)
+{
+    return empty() ? 0 : map::erase(_key_string(key));
+}
+
 void CrawlHashTable::assert_validity() const
 {
 #ifdef DEBUG
@@ -1318,6 +1350,16 @@ CrawlStoreValue& CrawlHashTable::get_value(const string &key)
     return map::operator[](key);
 }
 
+CrawlStoreValue& CrawlHashTable::get_value(const char *key)
+{
+    return get_value(_key_string(key));
+}
+
+const CrawlStoreValue& CrawlHashTable::get_value(const char *key) const
+{
+    return get_value(_key_string(key));
+}
+
 const CrawlStoreValue& CrawlHashTable::get_value(const string &key) const
 {
     ASSERT_VALIDITY();
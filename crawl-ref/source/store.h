@@ -255,19 +255,25 @@ public:
     void write(writer &) const;
     void read(reader &);
 
+    // The const char * overloads look up a cached string for the key
+    // instead of building one each time, and don't look at all when the
+    // table is empty.
     bool exists(const string &key) const;
+    bool exists(const char *key) const;
+
+    using map::erase;
+    size_type erase(const char *key);
 
     void assert_validity() const;
 
     // NOTE: If the const versions of get_value() or [] are given a
     // key which doesn't exist, they will assert.
     const CrawlStoreValue& get_value(const string &key) const;
-    const CrawlStoreValue& get_value(const char *key) const
-    { return get_value(string(key)); }
+    const CrawlStoreValue& get_value(const char *key) const;
     const CrawlStoreValue& operator[] (const string &key) const
     { return get_value(key); }
     const CrawlStoreValue& operator[] (const char *key) const
-    { return get_value(string(key)); }
+    { return get_value(key); }
 
     // NOTE: If get_value() or [] is given a key which doesn't exist
     // in the table, an unset/empty CrawlStoreValue will be created
@@ -277,11 +283,10 @@ public:
     // then trying to assign a different type to the CrawlStoreValue
     // will assert.
     CrawlStoreValue& get_value(const string &key);
-    CrawlStoreValue& get_value(const char *key)
-    { return get_value(string(key)); }
+    CrawlStoreValue& get_value(const char *key);
     using map::operator[];
     CrawlStoreValue& operator[] (const char *key)
-    { return get_value(string(key)); }
+    { return get_value(key); }
 };
 
 // A CrawlVector is the vector version of CrawlHashTable, except that
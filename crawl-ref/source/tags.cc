@@ -154,8 +154,18 @@ static NORETURN void _short_read(bool safe_read)
     die_noline("short read while reading save");
 }
 
-// Reads input in network byte order, from a file or buffer.
-unsigned char reader::readByte()
+// Refills the buffer from the save chunk; false if nothing is left.
+bool reader::_fill_buffer()
+{
+    ASSERT(_chunk);
+    _buf_pos = 0;
+    _buf_len = _chunk->read(_buf, sizeof(_buf));
+    return _buf_len;
+}
+
+// Reads input in network byte order, from a file or buffer. readByte()
+// only comes here once the buffered bytes are used up.
+unsigned char reader::_read_byte()
 {
     if (_file)
     {
@@ -166,10 +176,9 @@ unsigned char reader::readByte()
     }
     else if (_chunk)
     {
-        unsigned char buf;
-        if (_chunk->read(&buf, 1) != 1)
+        if (!_fill_buffer())
             _short_read(_safe_read);
-        return buf;
+        return _buf[_buf_pos++];
     }
     else
     {
@@ -193,8 +202,21 @@ void reader::read(void *data, size_t size)
     }
     else if (_chunk)
     {
-        if (_chunk->read(data, size) != size)
-            _short_read(_safe_read);
+        unsigned char *out = static_cast<unsigned char *>(data);
+        while (size)
+        {
+            if (_buf_pos == _buf_len && !_fill_buffer())
+                _short_read(_safe_read);
+
+            const size_t n = min(size, _buf_len - _buf_pos);
+            if (out)
+            {
+                memcpy(out, _buf + _buf_pos, n);
+                out += n;
+            }
+            _buf_pos += n;
+            size -= n;
+        }
     }
     else
     {
@@ -221,7 +243,7 @@ void reader::setMinorVersion(int minorVersion)
 void reader::fail_if_not_eof(const string &name)
 {
     char dummy;
-    if (_chunk ? _chunk->read(&dummy, 1) :
+    if (_chunk ? _buf_pos < _buf_len || _chunk->read(&dummy, 1) :
         _file ? (fgetc(_file) != EOF) :
         _read_offset >= _pbuf->size())
     {
@@ -239,17 +261,21 @@ void writer::check_ok(bool ok)
     }
 }
 
-void writer::writeByte(unsigned char ch)
+writer::~writer()
 {
-    if (failed)
-        return;
-
     if (_chunk)
-        _chunk->write(&ch, 1);
-    else if (_file)
-        check_ok(fputc(ch, _file) != EOF);
-    else
-        _pbuf->push_back(ch);
+    {
+        flush();
+        delete _chunk;
+    }
+}
+
+// Hands the buffered bytes over to the save chunk.
+void writer::flush()
+{
+    if (_buf_len && !failed)
+        _chunk->write(_buf, _buf_len);
+    _buf_len = 0;
 }
 
 void writer::write(const void *data, size_t size)
@@ -258,7 +284,17 @@ void writer::write(const void *data, size_t size)
         return;
 
     if (_chunk)
-        _chunk->write(data, size);
+    {
+        if (_buf_len + size > sizeof(_buf))
+            flush();
+        if (size < sizeof(_buf))
+        {
+            memcpy(_buf + _buf_len, data, size);
+            _buf_len += size;
+        }
+        else
+            _chunk->write(data, size);
+    }
     else if (_file)
         check_ok(fwrite(data, 1, size, _file) == size);
     else
@@ -3728,6 +3764,7 @@ static void tag_read_you_items(reader &th)
         for (int j = count2; j < MAX_SUBTYPES; ++j)
             you.type_ids[i][j] = false;
     }
+    invalidate_item_names();
 
 #if TAG_MAJOR_VERSION == 34
     if (th.getMinorVersion() < TAG_MINOR_ID_STATES)
@@ -37,24 +37,32 @@ class writer
 public:
     writer(const string &filename, FILE* output, bool ignore_errors = false)
         : _filename(filename), _file(output), _chunk(0),
-          _ignore_errors(ignore_errors), _pbuf(0), failed(false)
+          _ignore_errors(ignore_errors), _pbuf(0), _buf_len(0), failed(false)
     {
         ASSERT(output);
     }
     writer(vector<unsigned char>* poutput)
         : _filename(), _file(0), _chunk(0), _ignore_errors(false),
-          _pbuf(poutput), failed(false) { ASSERT(poutput); }
+          _pbuf(poutput), _buf_len(0), failed(false) { ASSERT(poutput); }
     writer(package *save, const string &chunkname)
         : _filename(), _file(0), _chunk(0), _ignore_errors(false),
-          failed(false)
+          _buf_len(0), failed(false)
     {
         ASSERT(save);
         _chunk = save->writer(chunkname);
     }
 
-    ~writer() { if (_chunk) delete _chunk; }
+    ~writer();
 
-    void writeByte(unsigned char byte);
+    void writeByte(unsigned char byte)
+    {
+        // Bytes for a save chunk are gathered here and handed over a
+        // block at a time.
+        if (_chunk && _buf_len < sizeof(_buf))
+            _buf[_buf_len++] = byte;
+        else
+            write(&byte, 1);
+    }
     void write(const void *data, size_t size);
     long tell();
 
@@ -62,6 +70,7 @@ public:
 
 private:
     void check_ok(bool ok);
+    void flush();
 
 private:
     string _filename;
@@ -71,6 +80,9 @@ private:
 
     vector<unsigned char>* _pbuf;
 
+    unsigned char _buf[4096];
+    size_t _buf_len;
+
     bool failed;
 };
 
@@ -108,7 +120,14 @@ public:
            int minorVersion = TAG_MINOR_INVALID);
     ~reader();
 
-    unsigned char readByte();
+    unsigned char readByte()
+    {
+        // Save chunks are read a block at a time; most bytes come from
+        // what is left of the last block.
+        if (_buf_pos < _buf_len)
+            return _buf[_buf_pos++];
+        return _read_byte();
+    }
     void read(void *data, size_t size);
     void advance(size_t size);
     int getMinorVersion() const;
@@ -121,6 +140,10 @@ public:
 
     void set_safe_read(bool setting) { _safe_read = setting; }
 
+private:
+    unsigned char _read_byte();
+    bool _fill_buffer();
+
 private:
     string _filename;
     FILE* _file;
@@ -128,6 +151,9 @@ private:
     bool  opened_file;
     const vector<unsigned char>* _pbuf;
     unsigned int _read_offset;
+    unsigned char _buf[4096];
+    size_t _buf_pos = 0;
+    size_t _buf_len = 0;
     int _minorVersion;
     // always throw an exception rather than dying when reading past EOF
     bool _safe_read;
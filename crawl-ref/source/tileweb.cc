@@ -16,6 +16,7 @@
 #include "branch.h"
 #include "command.h"
 #include "coord.h"
+#include "dbg-prof.h"
 #include "directn.h"
 #include "english.h"
 #include "env.h"
@@ -1430,6 +1431,7 @@ void TilesFramework::_send_map(bool force_full)
 
     coord_def last_gc(0, 0);
     bool send_gc = true;
+    vector<coord_def> sent;
 
     json_open_array("cells");
     for (int y = 0; y < GYM; y++)
@@ -1450,6 +1452,7 @@ void TilesFramework::_send_map(bool force_full)
             }
 
             mark_clean(gc);
+            sent.push_back(gc);
 
             if (m_origin.equals(-1, -1))
                 m_origin = gc;
@@ -1493,7 +1496,11 @@ void TilesFramework::_send_map(bool force_full)
     if (m_mcache_ref_done)
         _mcache_ref(false);
 
-    m_current_map_knowledge = env.map_knowledge;
+    // Only what was sent is what the client now has; copying the whole
+    // level's knowledge would also deep-copy every remembered monster and
+    // item on it.
+    for (const coord_def &gc : sent)
+        m_current_map_knowledge(gc) = env.map_knowledge(gc);
     m_current_view = m_next_view;
 
     _mcache_ref(true);
@@ -1742,6 +1749,7 @@ void TilesFramework::cgotoxy(int x, int y, GotoRegion region)
 
 void TilesFramework::redraw()
 {
+    PROF_SCOPE("webtiles redraw");
     if (!has_receivers())
     {
         if (m_mcache_ref_done)
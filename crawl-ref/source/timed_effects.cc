@@ -16,6 +16,7 @@
 #include "cloud.h"
 #include "coordit.h"
 #include "database.h"
+#include "dbg-prof.h"
 #include "dgn-shoals.h"
 #include "dgnevent.h"
 #include "dungeon.h"
@@ -1406,6 +1407,7 @@ void monster::timeout_enchantments(int levels)
  */
 void update_level(int elapsedTime)
 {
+    PROF_SCOPE("update_level");
     ASSERT(!crawl_state.game_is_arena());
 
     const int turns = elapsedTime / 10;
@@ -23,6 +23,7 @@
 #include "coord.h"
 #include "coordit.h"
 #include "database.h"
+#include "dbg-prof.h"
 #include "delay.h"
 #include "dgn-overview.h"
 #include "directn.h"
@@ -36,6 +37,7 @@
 #include "godconduct.h"
 #include "godpassive.h"
 #include "godwrath.h"
+#include "hash.h"
 #include "hints.h"
 #include "itemname.h" // item_type_known
 #include "itemprop.h" // get_weapon_brand
@@ -1335,6 +1337,151 @@ void run_animation(animation_type anim, use_animation_type type, bool cleanup)
     }
 }
 
+// What a view cell outside the player's sight was last drawn from. Such
+// a cell is only redrawn when one of these changes; cells in sight, and
+// those whose look can change from one frame to the next (elemental
+// colours, anything with a monster, item or cloud on it, exclusions), are
+// always redrawn.
+struct view_cell_memo
+{
+    bool valid = false;
+    coord_def gc;
+    uint32_t flags = 0;
+    dungeon_feature_type feat = DNGN_UNSEEN;
+    unsigned short feat_colour = 0;
+    trap_type trap = TRAP_UNASSIGNED;
+    terrain_property_t pgrid = 0;
+#ifdef USE_TILE
+    tileidx_t bk_fg = 0;
+    tileidx_t bk_bg = 0;
+    tileidx_t bk_cloud = 0;
+    tile_flavour flv;
+#endif
+};
+
+// Things every cell's look depends on; if any changes, so may all of them.
+struct view_memo_key
+{
+    const screen_cell_t *buffer = nullptr;
+    coord_def size;
+    level_id place;
+    bool on_current_level = false;
+    unsigned int options_generation = 0;
+    int forest_awoken_until = 0;
+    uint32_t trail_hash = 0;
+
+    bool operator==(const view_memo_key &o) const
+    {
+        return buffer == o.buffer && size == o.size && place == o.place
+               && on_current_level == o.on_current_level
+               && options_generation == o.options_generation
+               && forest_awoken_until == o.forest_awoken_until
+               && trail_hash == o.trail_hash;
+    }
+};
+
+static vector<view_cell_memo> _view_memo;
+static view_memo_key _view_memo_key;
+
+// Flags that make a cell's colour or tile vary randomly from frame to frame.
+#if TAG_MAJOR_VERSION == 34
+static const uint32_t _volatile_map_flags = MAP_SANCTUARY_2 | MAP_ORB_HALOED
+                                            | MAP_DISJUNCT | MAP_HOT;
+#else
+static const uint32_t _volatile_map_flags = MAP_SANCTUARY_2 | MAP_ORB_HALOED
+                                            | MAP_DISJUNCT;
+#endif
+
+void invalidate_view_cells()
+{
+    _view_memo.clear();
+}
+
+// Whether draw_cell() would draw gc from memory rather than from sight,
+// given that all layers are shown.
+static bool _draws_outside_los(const coord_def &gc)
+{
+    if (!map_bounds(gc) || !crawl_view.in_los_bounds_g(gc))
+        return true;
+    if (gc == you.pos() && you.on_current_level
+        && !crawl_state.game_is_arena() && !crawl_state.arena_suspended)
+    {
+        return false;
+    }
+    return !(you.see_cell(gc) && you.on_current_level);
+}
+
+// Whether anything but the remembered terrain is drawn at gc.
+static bool _cell_is_volatile(const coord_def &gc)
+{
+    const map_cell &mc = env.map_knowledge(gc);
+    return mc.flags & _volatile_map_flags
+           || mc.item() || mc.monsterinfo() || mc.cloudinfo()
+           || is_excluded(gc) || is_exclude_root(gc);
+}
+
+static view_cell_memo _view_cell_memo(const coord_def &gc)
+{
+    view_cell_memo memo;
+    memo.valid = true;
+    memo.gc = gc;
+    if (!map_bounds(gc))
+        return memo;
+
+    const map_cell &mc = env.map_knowledge(gc);
+    memo.flags = mc.flags;
+    memo.feat = mc.feat();
+    memo.feat_colour = mc.feat_colour();
+    memo.trap = mc.trap();
+    memo.pgrid = env.pgrid(gc);
+#ifdef USE_TILE
+    memo.bk_fg = env.tile_bk_fg(gc);
+    memo.bk_bg = env.tile_bk_bg(gc);
+    memo.bk_cloud = env.tile_bk_cloud(gc);
+    memo.flv = env.tile_flv(gc);
+#endif
+    return memo;
+}
+
+static bool _view_cell_unchanged(const view_cell_memo &memo,
+                                 const coord_def &gc)
+{
+    if (!memo.valid || memo.gc != gc || !_draws_outside_los(gc))
+        return false;
+    if (!map_bounds(gc))
+        return true;
+    if (_cell_is_volatile(gc))
+        return false;
+
+    const view_cell_memo now = _view_cell_memo(gc);
+    return memo.flags == now.flags && memo.feat == now.feat
+           && memo.feat_colour == now.feat_colour && memo.trap == now.trap
+           && memo.pgrid == now.pgrid
+#ifdef USE_TILE
+           && memo.bk_fg == now.bk_fg && memo.bk_bg == now.bk_bg
+           && memo.bk_cloud == now.bk_cloud
+           && !memcmp(&memo.flv, &now.flv, sizeof(tile_flavour))
+#endif
+           ;
+}
+
+static view_memo_key _current_view_memo_key()
+{
+    view_memo_key key;
+    key.buffer = crawl_view.vbuf;
+    key.size = crawl_view.vbuf.size();
+    key.place = level_id::current();
+    key.on_current_level = you.on_current_level;
+    key.options_generation = Options.generation;
+    key.forest_awoken_until = env.forest_awoken_until;
+    if (Options.show_travel_trail && !env.travel_trail.empty())
+    {
+        key.trail_hash = hash32(&env.travel_trail[0],
+                                env.travel_trail.size() * sizeof(coord_def));
+    }
+    return key;
+}
+
 /**
  * Draws the main window using the character set returned
  * by get_show_glyph().
@@ -1348,6 +1495,7 @@ void run_animation(animation_type anim, use_animation_type type, bool cleanup)
  */
 void viewwindow(bool show_updates, bool tiles_only, animation *a)
 {
+    PROF_SCOPE("viewwindow");
     // The player could be at (0,0) if we are called during level-gen; this can
     // happen via mpr -> interrupt_activity -> stop_delay -> runrest::stop
     if (you.duration[DUR_TIME_STEP] || you.pos().origin())
@@ -1405,21 +1553,51 @@ void viewwindow(bool show_updates, bool tiles_only, animation *a)
     if (flash_colour == BLACK)
         flash_colour = viewmap_flash_colour();
 
+    // Cells drawn from memory are kept from the last refresh if nothing
+    // they depend on has changed, unless something affects every cell
+    // this time.
+    const bool memo_usable = !a && !flash_colour
+                             && !crawl_state.darken_range
+                             && !crawl_state.flash_monsters
+                             && _layers == LAYERS_ALL
+                             && !you.beheld() && !you.afraid();
+    const view_memo_key memo_key = _current_view_memo_key();
+    const size_t ncells = crawl_view.viewsz.x * crawl_view.viewsz.y;
+    if (!(memo_key == _view_memo_key) || _view_memo.size() != ncells)
+    {
+        _view_memo.assign(ncells, view_cell_memo());
+        _view_memo_key = memo_key;
+    }
+
     const coord_def tl = coord_def(1, 1);
     const coord_def br = crawl_view.viewsz;
-    for (rectangle_iterator ri(tl, br); ri; ++ri)
+    view_cell_memo *memo = &_view_memo[0];
+    for (rectangle_iterator ri(tl, br); ri; ++ri, ++cell, ++memo)
     {
         // in grid coords
         const coord_def gc = a
             ? a->cell_cb(view2grid(*ri), flash_colour)
             : view2grid(*ri);
 
+        if (!memo_usable)
+            memo->valid = false;
+        else if (_view_cell_unchanged(*memo, gc))
+            continue;
+
+        const unsigned int elements = element_colour_count;
         if (you.flash_where && you.flash_where->is_affected(gc) <= 0)
             draw_cell(cell, gc, anim_updates, 0);
         else
             draw_cell(cell, gc, anim_updates, flash_colour);
 
-        cell++;
+        if (memo_usable && _draws_outside_los(gc)
+            && elements == element_colour_count
+            && (!map_bounds(gc) || !_cell_is_volatile(gc)))
+        {
+            *memo = _view_cell_memo(gc);
+        }
+        else
+            memo->valid = false;
     }
 
     you.last_view_update = you.num_turns;
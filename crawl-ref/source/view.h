@@ -68,6 +68,8 @@ void run_animation(animation_type anim, use_animation_type type,
                    bool cleanup = true);
 void viewwindow(bool show_updates = true, bool tiles_only = false,
                 animation *a = nullptr);
+// Make the next viewwindow() redraw every cell, not only the changed ones.
+void invalidate_view_cells();
 void draw_cell(screen_cell_t *cell, const coord_def &gc,
                bool anim_updates, int flash_colour);
 
@@ -65,13 +65,19 @@ namespace worley
 
     /* the function to merge-sort a "cube" of samples into the current best-found
        list of values. */
+    struct neighbourhood;
     static void AddSamples(int32_t xi, int32_t yi, int32_t zi, int32_t max_order,
             double at[3], double *F,
-            double (*delta)[3], uint32_t *ID);
+            double (*delta)[3], uint32_t *ID, neighbourhood *nb);
+    static void _move_neighbourhood(int32_t xi, int32_t yi, int32_t zi,
+                                    neighbourhood &nb);
 
-    /* The main function! */
+    /* The main function! If nb is given, it is used to hold the feature
+       points around the sample; consecutive samples in the same cube then
+       don't need to regenerate them. */
     static void _worley(double at[3], int32_t max_order,
-            double *F, double (*delta)[3], uint32_t *ID)
+            double *F, double (*delta)[3], uint32_t *ID,
+            neighbourhood *nb = nullptr)
     {
         double x2,y2,z2, mx2, my2, mz2;
         double new_at[3];
@@ -93,13 +99,16 @@ namespace worley
         int_at[1]=LFLOOR(new_at[1]);
         int_at[2]=LFLOOR(new_at[2]);
 
+        if (nb)
+            _move_neighbourhood(int_at[0], int_at[1], int_at[2], *nb);
+
         /* A simple way to compute the closest neighbors would be to test all
            boundary cubes exhaustively. This is simple with code like:
            {
            int32_t ii, jj, kk;
            for (ii=-1; ii<=1; ii++) for (jj=-1; jj<=1; jj++) for (kk=-1; kk<=1; kk++)
            AddSamples(int_at[0]+ii,int_at[1]+jj,int_at[2]+kk,
-           max_order, new_at, F, delta, ID);
+           max_order, new_at, F, delta, ID, nb);
            }
            But this wastes a lot of time working on cubes which are known to be
            too far away to matter! So we can use a more complex testing method
@@ -107,7 +116,7 @@ namespace worley
            speed of the algorithm. */
 
         /* Test the central cube for closest point(s). */
-        AddSamples(int_at[0], int_at[1], int_at[2], max_order, new_at, F, delta, ID);
+        AddSamples(int_at[0], int_at[1], int_at[2], max_order, new_at, F, delta, ID, nb);
 
         /* We test if neighbor cubes are even POSSIBLE contributors by examining the
            combinations of the sum of the squared distances from the cube's lower
@@ -125,62 +134,62 @@ namespace worley
         /* Test 6 facing neighbors of center cube. These are closest and most
            likely to have a close feature point. */
         if (x2<F[max_order-1])  AddSamples(int_at[0]-1, int_at[1]  , int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (y2<F[max_order-1])  AddSamples(int_at[0]  , int_at[1]-1, int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (z2<F[max_order-1])  AddSamples(int_at[0]  , int_at[1]  , int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
 
         if (mx2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]  , int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (my2<F[max_order-1]) AddSamples(int_at[0]  , int_at[1]+1, int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mz2<F[max_order-1]) AddSamples(int_at[0]  , int_at[1]  , int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
 
         /* Test 12 "edge cube" neighbors if necessary. They're next closest. */
         if ( x2+ y2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]-1, int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( x2+ z2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]  , int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( y2+ z2<F[max_order-1]) AddSamples(int_at[0]  , int_at[1]-1, int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+my2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]+1, int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+mz2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]  , int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (my2+mz2<F[max_order-1]) AddSamples(int_at[0]  , int_at[1]+1, int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( x2+my2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]+1, int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( x2+mz2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]  , int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( y2+mz2<F[max_order-1]) AddSamples(int_at[0]  , int_at[1]-1, int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+ y2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]-1, int_at[2]  ,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+ z2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]  , int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (my2+ z2<F[max_order-1]) AddSamples(int_at[0]  , int_at[1]+1, int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
 
         /* Final 8 "corner" cubes */
         if ( x2+ y2+ z2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]-1, int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( x2+ y2+mz2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]-1, int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( x2+my2+ z2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]+1, int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if ( x2+my2+mz2<F[max_order-1]) AddSamples(int_at[0]-1, int_at[1]+1, int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+ y2+ z2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]-1, int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+ y2+mz2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]-1, int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+my2+ z2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]+1, int_at[2]-1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
         if (mx2+my2+mz2<F[max_order-1]) AddSamples(int_at[0]+1, int_at[1]+1, int_at[2]+1,
-                max_order, new_at, F, delta, ID);
+                max_order, new_at, F, delta, ID, nb);
 
         /* We're done! Convert everything to right size scale */
         for (i=0; i<max_order; i++)
@@ -194,13 +203,18 @@ namespace worley
         return;
     }
 
-    static void AddSamples(int32_t xi, int32_t yi, int32_t zi, int32_t max_order,
-            double at[3], double *F,
-            double (*delta)[3], uint32_t *ID)
+    /* The feature points of one cube. There are at most 5. */
+    struct cube_points
     {
-        double dx, dy, dz, fx, fy, fz, d2;
-        int32_t count, i, j, index;
-        uint32_t seed, this_id;
+        int32_t count;
+        uint32_t id[5];
+        double f[5][3];
+    };
+
+    static void _cube_points(int32_t xi, int32_t yi, int32_t zi,
+                             cube_points &cube)
+    {
+        uint32_t seed;
 
         /* Each cube has a random number seed based on the cube's ID number.
            The seed might be better if it were a nonlinear hash like Perlin uses
@@ -209,22 +223,81 @@ namespace worley
         seed=702395077*xi + 915488749*yi + 2120969693*zi;
 
         /* How many feature points are in this cube? */
-        count=Poisson_count[(seed>>24)%256]; /* 256 element lookup table. Use MSB */
+        cube.count=Poisson_count[(seed>>24)%256]; /* 256 element lookup table. Use MSB */
 
         seed=1402024253*seed+586950981; /* churn the seed with good Knuth LCG */
 
-        for (j=0; j<count; j++) /* test and insert each point into our solution */
+        for (int32_t j=0; j<cube.count; j++)
         {
-            this_id=seed;
+            cube.id[j]=seed;
             seed=1402024253*seed+586950981; /* churn */
 
             /* compute the 0..1 feature point location's XYZ */
-            fx=(seed+0.5)*(1.0/4294967296.0);
+            cube.f[j][0]=(seed+0.5)*(1.0/4294967296.0);
             seed=1402024253*seed+586950981; /* churn */
-            fy=(seed+0.5)*(1.0/4294967296.0);
+            cube.f[j][1]=(seed+0.5)*(1.0/4294967296.0);
             seed=1402024253*seed+586950981; /* churn */
-            fz=(seed+0.5)*(1.0/4294967296.0);
+            cube.f[j][2]=(seed+0.5)*(1.0/4294967296.0);
             seed=1402024253*seed+586950981; /* churn */
+        }
+    }
+
+    /* The 3x3x3 block of cubes around a sample's cube, which are all that
+       _worley() can ever look at. Their points are generated as they are
+       first needed and kept while following samples stay in the same
+       central cube. */
+    struct neighbourhood
+    {
+        int32_t xi, yi, zi;
+        uint32_t known; /* bitmask of the cubes[] already generated */
+        cube_points cubes[27];
+
+        neighbourhood() : xi(0), yi(0), zi(0), known(0) { }
+    };
+
+    static void _move_neighbourhood(int32_t xi, int32_t yi, int32_t zi,
+                                    neighbourhood &nb)
+    {
+        if (nb.xi == xi && nb.yi == yi && nb.zi == zi)
+            return;
+
+        nb.xi = xi;
+        nb.yi = yi;
+        nb.zi = zi;
+        nb.known = 0;
+    }
+
+    static void AddSamples(int32_t xi, int32_t yi, int32_t zi, int32_t max_order,
+            double at[3], double *F,
+            double (*delta)[3], uint32_t *ID, neighbourhood *nb)
+    {
+        double dx, dy, dz, fx, fy, fz, d2;
+        int32_t count, i, j, index;
+        uint32_t this_id;
+
+        cube_points local;
+        cube_points *cube = &local;
+        if (nb)
+        {
+            const int32_t slot = (xi - nb->xi + 1)*9 + (yi - nb->yi + 1)*3
+                                 + (zi - nb->zi + 1);
+            cube = &nb->cubes[slot];
+            if (!(nb->known & (1 << slot)))
+            {
+                _cube_points(xi, yi, zi, *cube);
+                nb->known |= 1 << slot;
+            }
+        }
+        else
+            _cube_points(xi, yi, zi, local);
+        count=cube->count;
+
+        for (j=0; j<count; j++) /* test and insert each point into our solution */
+        {
+            this_id=cube->id[j];
+            fx=cube->f[j][0];
+            fy=cube->f[j][1];
+            fz=cube->f[j][2];
 
             /* delta from feature point to sample location */
             dx=xi+fx-at[0];
@@ -281,14 +354,15 @@ cases.]
         return;
     }
 
-    noise_datum noise(double x, double y, double z)
+    static noise_datum _noise(double x, double y, double z,
+                              neighbourhood *nb)
     {
         double point[3] = {x,y,z};
         double F[2];
         double delta[2][3];
         uint32_t id[2];
 
-        _worley(point, 2, F, delta, id);
+        _worley(point, 2, F, delta, id, nb);
 
         noise_datum datum;
         datum.distance[0] = F[0];
@@ -300,4 +374,16 @@ cases.]
                 datum.pos[i][j] = delta[i][j];
         return datum;
     }
+
+    noise_datum noise(double x, double y, double z)
+    {
+        return _noise(x, y, z, nullptr);
+    }
+
+    void noise_batch(const double *points, int count, noise_datum *out)
+    {
+        neighbourhood nb;
+        for (int i = 0; i < count; ++i, points += 3)
+            out[i] = _noise(points[0], points[1], points[2], &nb);
+    }
 }
@@ -69,5 +69,11 @@ struct noise_datum
 };
 
 noise_datum noise(double x, double y, double z);
+
+// Evaluate count points at once; points holds count (x, y, z) triples.
+// Feature points of the lattice cubes are shared between nearby samples, so
+// this is considerably cheaper than calling noise() on each point of a row
+// or rectangle, and gives the same results.
+void noise_batch(const double *points, int count, noise_datum *out);
 }
 #endif /* WORLEY_H */